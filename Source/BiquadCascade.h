@@ -0,0 +1,204 @@
+/*
+  ==============================================================================
+
+    BiquadCascade.h
+
+    Fused transposed direct form II cascade. Coefficients are stored inline
+    in structure-of-arrays form and every active section runs per sample,
+    in chunks whose length is a template parameter, so the section state
+    stays in registers for the whole block. Lanes of a SIMD sample type can
+    be given coefficients of their own, so channels sharing one pass don't
+    have to share one design. SIMD cascades can also be run by DSPKernels,
+    built for the widest instruction set the CPU has.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "EQCoefficients.h"
+#include "DSPKernels.h"
+
+//==============================================================================
+template <typename SampleType>
+class BiquadCascade {
+public:
+    static constexpr int maxSections = EQCoefficients::maxTotalSections;
+
+    // Sections fused into one pass over the block. Four covers a 48 dB/oct cut
+    // and keeps the state of every section in registers on SSE/NEON.
+    static constexpr int maxFusedSections = 4;
+
+    // Replaces the active sections. Each section carries a key identifying
+    // the band stage it belongs to, so filter state follows the stage when
+    // sections are added or removed elsewhere in the cascade.
+    void setSections(const BiquadCoefficients* sections, const int* sectionKeys, int numSectionsToUse) noexcept {
+        numSectionsToUse = juce::jlimit(0, maxSections, numSectionsToUse);
+
+        if (!hasSameLayout(sectionKeys, numSectionsToUse))
+            remapState(sectionKeys, numSectionsToUse);
+
+        for (int section = 0; section < numSectionsToUse; ++section) {
+            b0[section] = expand(sections[section].b0);
+            b1[section] = expand(sections[section].b1);
+            b2[section] = expand(sections[section].b2);
+            a1[section] = expand(sections[section].a1);
+            a2[section] = expand(sections[section].a2);
+        }
+
+        numSections = numSectionsToUse;
+    }
+
+    // Swaps one section's coefficients without touching the layout or state,
+    // e.g. for per-sub-block gain changes.
+    void setSection(int section, const BiquadCoefficients& coefficients) noexcept {
+        jassert(section >= 0 && section < numSections);
+
+        b0[section] = expand(coefficients.b0);
+        b1[section] = expand(coefficients.b1);
+        b2[section] = expand(coefficients.b2);
+        a1[section] = expand(coefficients.a1);
+        a2[section] = expand(coefficients.a2);
+    }
+
+    // Gives one lane its own coefficients for a section of the current
+    // layout; the next setSections or setSection call overwrites them.
+    void setLaneSection(int section, int lane, const BiquadCoefficients& coefficients) noexcept {
+        jassert(section >= 0 && section < numSections);
+
+        setLane(b0[section], lane, coefficients.b0);
+        setLane(b1[section], lane, coefficients.b1);
+        setLane(b2[section], lane, coefficients.b2);
+        setLane(a1[section], lane, coefficients.a1);
+        setLane(a2[section], lane, coefficients.a2);
+    }
+
+    void reset() noexcept {
+        z1.fill(expand(0.0f));
+        z2.fill(expand(0.0f));
+    }
+
+    int getNumSections() const noexcept { return numSections; }
+
+    void process(SampleType* samples, int numSamples) noexcept {
+        for (int first = 0; first < numSections; first += maxFusedSections) {
+            switch (juce::jmin(maxFusedSections, numSections - first)) {
+                case 4: processFused<4>(first, samples, numSamples); break;
+                case 3: processFused<3>(first, samples, numSamples); break;
+                case 2: processFused<2>(first, samples, numSamples); break;
+                case 1: processFused<1>(first, samples, numSamples); break;
+                default: jassertfalse; break;
+            }
+        }
+    }
+
+    // The same filter run by one of the runtime-selected kernels; for SIMD
+    // sample types, whose lanes are laid out as plain floats.
+    void process(SampleType* samples, int numSamples, const DSPKernels& kernels) noexcept {
+        static_assert(!std::is_same_v<SampleType, float>, "The kernels filter interleaved SIMD frames");
+
+        const DSPKernels::CascadeState state{ lanes(b0), lanes(b1), lanes(b2), lanes(a1), lanes(a2), lanes(z1), lanes(z2),
+                                              numSections, static_cast<int>(SampleType::size()) };
+        kernels.cascade(state, reinterpret_cast<float*>(samples), numSamples);
+    }
+
+private:
+    static float* lanes(std::array<SampleType, maxSections>& registers) noexcept {
+        return reinterpret_cast<float*>(registers.data());
+    }
+
+    static SampleType expand(float value) noexcept {
+        if constexpr (std::is_same_v<SampleType, float>)
+            return value;
+        else
+            return SampleType::expand(value);
+    }
+
+    static void setLane(SampleType& target, int lane, float value) noexcept {
+        if constexpr (std::is_same_v<SampleType, float>) {
+            jassert(lane == 0);
+            target = value;
+        }
+        else {
+            target.set(static_cast<size_t>(lane), value);
+        }
+    }
+
+    template <int NumSections>
+    void processFused(int first, SampleType* samples, int numSamples) noexcept {
+        SampleType cb0[NumSections], cb1[NumSections], cb2[NumSections], ca1[NumSections], ca2[NumSections];
+        SampleType s1[NumSections], s2[NumSections];
+
+        for (int k = 0; k < NumSections; ++k) {
+            cb0[k] = b0[first + k];
+            cb1[k] = b1[first + k];
+            cb2[k] = b2[first + k];
+            ca1[k] = a1[first + k];
+            ca2[k] = a2[first + k];
+            s1[k] = z1[first + k];
+            s2[k] = z2[first + k];
+        }
+
+        for (int i = 0; i < numSamples; ++i) {
+            SampleType x = samples[i];
+
+            for (int k = 0; k < NumSections; ++k) {
+                const SampleType y = (x * cb0[k]) + s1[k];
+                s1[k] = (x * cb1[k]) - (y * ca1[k]) + s2[k];
+                s2[k] = (x * cb2[k]) - (y * ca2[k]);
+                x = y;
+            }
+
+            samples[i] = x;
+        }
+
+        for (int k = 0; k < NumSections; ++k) {
+            juce::dsp::util::snapToZero(s1[k]);
+            juce::dsp::util::snapToZero(s2[k]);
+            z1[first + k] = s1[k];
+            z2[first + k] = s2[k];
+        }
+    }
+
+    bool hasSameLayout(const int* sectionKeys, int count) const noexcept {
+        if (count != numSections)
+            return false;
+
+        for (int section = 0; section < count; ++section)
+            if (keys[section] != sectionKeys[section])
+                return false;
+
+        return true;
+    }
+
+    // Moves the state of every stage that survives into its new position and
+    // starts newly engaged stages from silence.
+    void remapState(const int* sectionKeys, int count) noexcept {
+        std::array<SampleType, maxSections> newZ1, newZ2;
+
+        for (int section = 0; section < count; ++section) {
+            newZ1[section] = expand(0.0f);
+            newZ2[section] = expand(0.0f);
+
+            for (int old = 0; old < numSections; ++old) {
+                if (keys[old] == sectionKeys[section]) {
+                    newZ1[section] = z1[old];
+                    newZ2[section] = z2[old];
+                    break;
+                }
+            }
+        }
+
+        for (int section = 0; section < count; ++section) {
+            z1[section] = newZ1[section];
+            z2[section] = newZ2[section];
+            keys[section] = sectionKeys[section];
+        }
+    }
+
+    std::array<SampleType, maxSections> b0{}, b1{}, b2{}, a1{}, a2{};
+    std::array<SampleType, maxSections> z1{}, z2{};
+    std::array<int, maxSections> keys{};
+    int numSections{ 0 };
+};
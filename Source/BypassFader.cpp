@@ -0,0 +1,100 @@
+/*
+  ==============================================================================
+
+    BypassFader.cpp
+
+  ==============================================================================
+*/
+
+#include "BypassFader.h"
+
+void BypassFader::prepare(double sampleRate, int maximumBlockSize, int numChannels, int maxLatencySamples) {
+    maxLatency = juce::jmax(0, maxLatencySamples);
+    latency = juce::jmin(latency, maxLatency);
+
+    delayLine.setSize(juce::jmax(1, numChannels), maxLatency + juce::jmax(1, maximumBlockSize));
+    dry.setSize(juce::jmax(1, numChannels), juce::jmax(1, maximumBlockSize));
+    gains.assign(static_cast<size_t>(juce::jmax(1, maximumBlockSize)), 1.0f);
+    kernels = &DSPKernels::select();
+
+    wetGain.reset(sampleRate, fadeLengthSeconds);
+    reset();
+}
+
+void BypassFader::reset() noexcept {
+    wetGain.setCurrentAndTargetValue(bypassed ? 0.0f : 1.0f);
+    delayLine.clear();
+    writePosition = 0;
+}
+
+void BypassFader::setLatency(int latencySamples) noexcept {
+    latency = juce::jlimit(0, maxLatency, latencySamples);
+}
+
+void BypassFader::setBypassed(bool shouldBeBypassed) noexcept {
+    if (shouldBeBypassed == bypassed)
+        return;
+
+    bypassed = shouldBeBypassed;
+    wetGain.setTargetValue(bypassed ? 0.0f : 1.0f);
+}
+
+void BypassFader::pushInput(const juce::dsp::AudioBlock<const float>& input) noexcept {
+    const int numSamples = juce::jmin(static_cast<int>(input.getNumSamples()), dry.getNumSamples());
+    const int numChannels = juce::jmin(static_cast<int>(input.getNumChannels()), dry.getNumChannels());
+    const bool needsDry = isFading() || (isBypassed() && latency > 0);
+
+    // Without latency the input is its own dry signal; it only has to be
+    // kept aside while the EQ overwrites it during a fade.
+    if (latency == 0) {
+        if (needsDry)
+            for (int channel = 0; channel < numChannels; ++channel)
+                dry.copyFrom(channel, 0, input.getChannelPointer(static_cast<size_t>(channel)), numSamples);
+
+        return;
+    }
+
+    const int length = delayLine.getNumSamples();
+    const int readPosition = (writePosition - latency + length) % length;
+
+    for (int channel = 0; channel < numChannels; ++channel) {
+        const float* source = input.getChannelPointer(static_cast<size_t>(channel));
+        float* line = delayLine.getWritePointer(channel);
+
+        const int firstPart = juce::jmin(numSamples, length - writePosition);
+        juce::FloatVectorOperations::copy(line + writePosition, source, firstPart);
+        juce::FloatVectorOperations::copy(line, source + firstPart, numSamples - firstPart);
+
+        if (needsDry) {
+            float* destination = dry.getWritePointer(channel);
+            const int firstRead = juce::jmin(numSamples, length - readPosition);
+            juce::FloatVectorOperations::copy(destination, line + readPosition, firstRead);
+            juce::FloatVectorOperations::copy(destination + firstRead, line, numSamples - firstRead);
+        }
+    }
+
+    writePosition = (writePosition + numSamples) % length;
+}
+
+void BypassFader::processBypassed(const juce::dsp::AudioBlock<float>& block) noexcept {
+    if (latency == 0)
+        return;
+
+    const int numSamples = juce::jmin(static_cast<int>(block.getNumSamples()), dry.getNumSamples());
+    const int numChannels = juce::jmin(static_cast<int>(block.getNumChannels()), dry.getNumChannels());
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        juce::FloatVectorOperations::copy(block.getChannelPointer(static_cast<size_t>(channel)), dry.getReadPointer(channel), numSamples);
+}
+
+void BypassFader::mix(const juce::dsp::AudioBlock<float>& wet) noexcept {
+    const int numSamples = juce::jmin(static_cast<int>(wet.getNumSamples()), dry.getNumSamples());
+    const int numChannels = juce::jmin(static_cast<int>(wet.getNumChannels()), dry.getNumChannels());
+
+    for (int sample = 0; sample < numSamples; ++sample)
+        gains[static_cast<size_t>(sample)] = wetGain.getNextValue();
+
+    // dry + (wet - dry) * gain: the two are correlated, so a linear fade keeps the level.
+    for (int channel = 0; channel < numChannels; ++channel)
+        kernels->crossfade(wet.getChannelPointer(static_cast<size_t>(channel)), dry.getReadPointer(channel), gains.data(), numSamples);
+}
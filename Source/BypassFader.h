@@ -0,0 +1,63 @@
+/*
+  ==============================================================================
+
+    BypassFader.h
+
+    True bypass for the whole EQ. Switching either way crossfades between
+    the processed block and the dry input over a few milliseconds; once the
+    processed side has faded out the EQ isn't run at all, and the dry input
+    is only delayed to line up with the latency the plugin reports.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DSPKernels.h"
+
+//==============================================================================
+class BypassFader {
+public:
+    static constexpr double fadeLengthSeconds = 0.01;
+
+    BypassFader() = default;
+
+    // Allocates the dry delay line and picks the crossfade kernel. Not realtime safe.
+    void prepare(double sampleRate, int maximumBlockSize, int numChannels, int maxLatencySamples);
+    void reset() noexcept;
+
+    // Delay for the dry signal, clamped to what prepare allowed for.
+    void setLatency(int latencySamples) noexcept;
+
+    // Starts a crossfade when the state changes.
+    void setBypassed(bool shouldBeBypassed) noexcept;
+
+    // Faded out completely: the EQ needn't run.
+    bool isBypassed() const noexcept { return bypassed && !wetGain.isSmoothing(); }
+    bool isFading() const noexcept { return wetGain.isSmoothing(); }
+
+    // Audio thread, once per block with the untouched input. Keeps the delay
+    // line current and, when it will be needed, holds the block's dry signal.
+    void pushInput(const juce::dsp::AudioBlock<const float>& input) noexcept;
+
+    // While bypassed: replaces the block with the delayed dry signal.
+    void processBypassed(const juce::dsp::AudioBlock<float>& block) noexcept;
+
+    // While fading: mixes the processed block with the dry signal in place.
+    void mix(const juce::dsp::AudioBlock<float>& wet) noexcept;
+
+private:
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> wetGain;
+    bool bypassed{ false };
+
+    juce::AudioBuffer<float> delayLine;     // circular, one row per channel
+    juce::AudioBuffer<float> dry;           // the current block's dry signal
+    std::vector<float> gains;
+    const DSPKernels* kernels{ DSPKernels::get(DSPKernels::Scalar) };
+    int writePosition{ 0 };
+    int latency{ 0 };
+    int maxLatency{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BypassFader)
+};
@@ -0,0 +1,223 @@
+/*
+  ==============================================================================
+
+    ChainSettings.cpp
+
+  ==============================================================================
+*/
+
+#include "ChainSettings.h"
+
+ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts) {
+    ChainSettings settings;
+
+    if (std::atomic<float>* param = apvts.getRawParameterValue("Peak1Freq"))
+        settings.peak1Frequency = param->load();
+    if (std::atomic<float>* param = apvts.getRawParameterValue("Peak1Gain"))
+        settings.peak1GainInDecibels = param->load();
+    if (std::atomic<float>* param = apvts.getRawParameterValue("Peak1Q"))
+        settings.peak1Quality = param->load();
+    if (std::atomic<float>* param = apvts.getRawParameterValue("Peak2Freq"))
+        settings.peak2Frequency = param->load();
+    if (std::atomic<float>* param = apvts.getRawParameterValue("Peak2Gain"))
+        settings.peak2GainInDecibels = param->load();
+    if (std::atomic<float>* param = apvts.getRawParameterValue("Peak2Q"))
+        settings.peak2Quality = param->load();
+
+    if (std::atomic<float>* param = apvts.getRawParameterValue("Peak1Dynamic"))
+        settings.peak1Dynamics.enabled = param->load() >= 0.5f;
+    if (std::atomic<float>* param = apvts.getRawParameterValue("Peak1Threshold"))
+        settings.peak1Dynamics.thresholdInDecibels = param->load();
+    if (std::atomic<float>* param = apvts.getRawParameterValue("Peak1Ratio"))
+        settings.peak1Dynamics.ratio = param->load();
+    if (std::atomic<float>* param = apvts.getRawParameterValue("Peak1Attack"))
+        settings.peak1Dynamics.attackMs = param->load();
+    if (std::atomic<float>* param = apvts.getRawParameterValue("Peak1Release"))
+        settings.peak1Dynamics.releaseMs = param->load();
+    if (std::atomic<float>* param = apvts.getRawParameterValue("Peak2Dynamic"))
+        settings.peak2Dynamics.enabled = param->load() >= 0.5f;
+    if (std::atomic<float>* param = apvts.getRawParameterValue("Peak2Threshold"))
+        settings.peak2Dynamics.thresholdInDecibels = param->load();
+    if (std::atomic<float>* param = apvts.getRawParameterValue("Peak2Ratio"))
+        settings.peak2Dynamics.ratio = param->load();
+    if (std::atomic<float>* param = apvts.getRawParameterValue("Peak2Attack"))
+        settings.peak2Dynamics.attackMs = param->load();
+    if (std::atomic<float>* param = apvts.getRawParameterValue("Peak2Release"))
+        settings.peak2Dynamics.releaseMs = param->load();
+    if (std::atomic<float>* param = apvts.getRawParameterValue("DynamicKey"))
+        settings.dynamicsFromSidechain = param->load() >= 0.5f;
+
+    if (std::atomic<float>* param = apvts.getRawParameterValue("LowCutFreq"))
+        settings.lowCutFrequency = param->load();
+    if (std::atomic<float>* param = apvts.getRawParameterValue("LowCutSlope"))
+        settings.lowCutSlope = static_cast<Slope>(param->load());
+    if (std::atomic<float>* param = apvts.getRawParameterValue("HighCutFreq"))
+        settings.highCutFrequency = param->load();
+    if (std::atomic<float>* param = apvts.getRawParameterValue("HighCutSlope"))
+        settings.highCutSlope = static_cast<Slope>(param->load());
+
+    if (std::atomic<float>* param = apvts.getRawParameterValue("OutputGain"))
+        settings.outputGain = param->load();
+    if (std::atomic<float>* param = apvts.getRawParameterValue("Bypass"))
+        settings.bypass = static_cast<bool>(param->load());
+    if (std::atomic<float>* param = apvts.getRawParameterValue("LinearPhase"))
+        settings.linearPhase = param->load() >= 0.5f;
+    if (std::atomic<float>* param = apvts.getRawParameterValue("Oversampling"))
+        settings.oversamplingOrder = juce::jlimit(0, 3, juce::roundToInt(param->load()));
+    if (std::atomic<float>* param = apvts.getRawParameterValue("FilterType"))
+        settings.peak1Type = static_cast<BandType>(juce::jlimit(0, 3, juce::roundToInt(param->load())));
+    if (std::atomic<float>* param = apvts.getRawParameterValue("Peak2Type"))
+        settings.peak2Type = static_cast<BandType>(juce::jlimit(0, 3, juce::roundToInt(param->load())));
+
+    for (int position = FirstExtraBand; position < maxBands; ++position) {
+        BandSettings& band = settings.extraBands[static_cast<size_t>(position - FirstExtraBand)];
+
+        if (std::atomic<float>* param = apvts.getRawParameterValue(getBandParameterID(position, "On")))
+            band.enabled = param->load() >= 0.5f;
+        if (std::atomic<float>* param = apvts.getRawParameterValue(getBandParameterID(position, "Type")))
+            band.type = static_cast<BandType>(juce::jlimit(0, 3, juce::roundToInt(param->load())));
+        if (std::atomic<float>* param = apvts.getRawParameterValue(getBandParameterID(position, "Freq")))
+            band.frequency = param->load();
+        if (std::atomic<float>* param = apvts.getRawParameterValue(getBandParameterID(position, "Gain")))
+            band.gainInDecibels = param->load();
+        if (std::atomic<float>* param = apvts.getRawParameterValue(getBandParameterID(position, "Q")))
+            band.quality = param->load();
+    }
+
+    if (std::atomic<float>* param = apvts.getRawParameterValue("StereoMode"))
+        settings.stereoMode = static_cast<StereoMode>(juce::jlimit(0, 1, juce::roundToInt(param->load())));
+
+    for (int position = 0; position < maxBands; ++position)
+        if (std::atomic<float>* param = apvts.getRawParameterValue(getPlacementParameterID(position)))
+            settings.placements[static_cast<size_t>(position)] = static_cast<BandPlacement>(juce::jlimit(0, 2, juce::roundToInt(param->load())));
+
+    return settings;
+}
+
+static bool setExtraBandParameter(ChainSettings& settings, const juce::String& parameterID, float value) {
+    const juce::String number = parameterID.substring(4).initialSectionContainingOnly("0123456789");
+    const juce::String field = parameterID.substring(4 + number.length());
+    const int position = number.getIntValue() - 1;
+
+    if (number.isEmpty() || position < FirstExtraBand || position >= maxBands)
+        return false;
+
+    BandSettings& band = settings.extraBands[static_cast<size_t>(position - FirstExtraBand)];
+
+    if (field == "On")          band.enabled = value >= 0.5f;
+    else if (field == "Type")   band.type = static_cast<BandType>(juce::jlimit(0, 3, juce::roundToInt(value)));
+    else if (field == "Freq")   band.frequency = value;
+    else if (field == "Gain")   band.gainInDecibels = value;
+    else if (field == "Q")      band.quality = value;
+    else if (field == "Placement")
+        settings.placements[static_cast<size_t>(position)] = static_cast<BandPlacement>(juce::jlimit(0, 2, juce::roundToInt(value)));
+    else return false;
+
+    return true;
+}
+
+bool setChainSettingsParameter(ChainSettings& settings, const juce::String& parameterID, float value) {
+    if (parameterID.startsWith("Band"))
+        return setExtraBandParameter(settings, parameterID, value);
+
+    for (const int position : { LowCut, PeakBand1, PeakBand2, HighCut }) {
+        if (parameterID == getPlacementParameterID(position)) {
+            settings.placements[static_cast<size_t>(position)] = static_cast<BandPlacement>(juce::jlimit(0, 2, juce::roundToInt(value)));
+            return true;
+        }
+    }
+
+    if (parameterID == "Peak1Freq")           settings.peak1Frequency = value;
+    else if (parameterID == "Peak1Gain")      settings.peak1GainInDecibels = value;
+    else if (parameterID == "Peak1Q")         settings.peak1Quality = value;
+    else if (parameterID == "Peak2Freq")      settings.peak2Frequency = value;
+    else if (parameterID == "Peak2Gain")      settings.peak2GainInDecibels = value;
+    else if (parameterID == "Peak2Q")         settings.peak2Quality = value;
+    else if (parameterID == "Peak1Dynamic")   settings.peak1Dynamics.enabled = value >= 0.5f;
+    else if (parameterID == "Peak1Threshold") settings.peak1Dynamics.thresholdInDecibels = value;
+    else if (parameterID == "Peak1Ratio")     settings.peak1Dynamics.ratio = value;
+    else if (parameterID == "Peak1Attack")    settings.peak1Dynamics.attackMs = value;
+    else if (parameterID == "Peak1Release")   settings.peak1Dynamics.releaseMs = value;
+    else if (parameterID == "Peak2Dynamic")   settings.peak2Dynamics.enabled = value >= 0.5f;
+    else if (parameterID == "Peak2Threshold") settings.peak2Dynamics.thresholdInDecibels = value;
+    else if (parameterID == "Peak2Ratio")     settings.peak2Dynamics.ratio = value;
+    else if (parameterID == "Peak2Attack")    settings.peak2Dynamics.attackMs = value;
+    else if (parameterID == "Peak2Release")   settings.peak2Dynamics.releaseMs = value;
+    else if (parameterID == "DynamicKey")     settings.dynamicsFromSidechain = value >= 0.5f;
+    else if (parameterID == "LowCutFreq")     settings.lowCutFrequency = value;
+    else if (parameterID == "LowCutSlope")    settings.lowCutSlope = static_cast<Slope>(juce::jlimit(0, 3, juce::roundToInt(value)));
+    else if (parameterID == "HighCutFreq")    settings.highCutFrequency = value;
+    else if (parameterID == "HighCutSlope")   settings.highCutSlope = static_cast<Slope>(juce::jlimit(0, 3, juce::roundToInt(value)));
+    else if (parameterID == "OutputGain")     settings.outputGain = value;
+    else if (parameterID == "Bypass")         settings.bypass = value >= 0.5f;
+    else if (parameterID == "LinearPhase")    settings.linearPhase = value >= 0.5f;
+    else if (parameterID == "Oversampling")   settings.oversamplingOrder = juce::jlimit(0, 3, juce::roundToInt(value));
+    else if (parameterID == "FilterType")     settings.peak1Type = static_cast<BandType>(juce::jlimit(0, 3, juce::roundToInt(value)));
+    else if (parameterID == "Peak2Type")      settings.peak2Type = static_cast<BandType>(juce::jlimit(0, 3, juce::roundToInt(value)));
+    else if (parameterID == "StereoMode")     settings.stereoMode = static_cast<StereoMode>(juce::jlimit(0, 1, juce::roundToInt(value)));
+    else return false;
+
+    return true;
+}
+
+BandSettings getBandSettings(const ChainSettings& chainSettings, int chainPosition) noexcept {
+    jassert(chainPosition != LowCut && chainPosition != HighCut);
+
+    if (chainPosition == PeakBand1)
+        return { true, chainSettings.peak1Type, chainSettings.peak1Frequency, chainSettings.peak1GainInDecibels, chainSettings.peak1Quality };
+
+    if (chainPosition == PeakBand2)
+        return { true, chainSettings.peak2Type, chainSettings.peak2Frequency, chainSettings.peak2GainInDecibels, chainSettings.peak2Quality };
+
+    return chainSettings.extraBands[static_cast<size_t>(juce::jlimit(0, numExtraBands - 1, chainPosition - FirstExtraBand))];
+}
+
+juce::String getBandParameterID(int chainPosition, const juce::String& field) {
+    return "Band" + juce::String(chainPosition + 1) + field;
+}
+
+juce::String getPlacementParameterID(int chainPosition) {
+    switch (chainPosition) {
+        case LowCut:    return "LowCutPlacement";
+        case PeakBand1: return "Peak1Placement";
+        case PeakBand2: return "Peak2Placement";
+        case HighCut:   return "HighCutPlacement";
+        default:        return getBandParameterID(chainPosition, "Placement");
+    }
+}
+
+double getProcessingSampleRate(const ChainSettings& chainSettings, double sampleRate) noexcept {
+    return sampleRate * (1 << chainSettings.oversamplingOrder);
+}
+
+ChainSettings getChainSettings(const juce::ValueTree& state) {
+    ChainSettings settings;
+
+    // AudioProcessorValueTreeState stores one PARAM child per parameter with
+    // its denormalised value.
+    for (const juce::ValueTree& child : state)
+        if (child.hasType("PARAM"))
+            setChainSettingsParameter(settings, child.getProperty("id").toString(), static_cast<float>(child.getProperty("value")));
+
+    return settings;
+}
+
+juce::ReferenceCountedObjectPtr<juce::dsp::IIR::Coefficients<float>> makeBandFilter(const BandSettings& band, double sampleRate) {
+    const float gainFactor = juce::Decibels::decibelsToGain(band.gainInDecibels);
+
+    switch (band.type) {
+        case LowShelf:  return juce::dsp::IIR::Coefficients<float>::makeLowShelf(sampleRate, band.frequency, band.quality, gainFactor);
+        case HighShelf: return juce::dsp::IIR::Coefficients<float>::makeHighShelf(sampleRate, band.frequency, band.quality, gainFactor);
+        case Notch:     return juce::dsp::IIR::Coefficients<float>::makeNotch(sampleRate, band.frequency, band.quality);
+        case Bell:
+        default:        return juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, band.frequency, band.quality, gainFactor);
+    }
+}
+
+std::pair<juce::ReferenceCountedObjectPtr<juce::dsp::IIR::Coefficients<float>>,
+          juce::ReferenceCountedObjectPtr<juce::dsp::IIR::Coefficients<float>>>
+    makePeakFilters(const ChainSettings& chainSettings, double sampleRate) {
+
+    return { makeBandFilter(getBandSettings(chainSettings, ChainPositions::PeakBand1), sampleRate),
+             makeBandFilter(getBandSettings(chainSettings, ChainPositions::PeakBand2), sampleRate) };
+}
@@ -0,0 +1,128 @@
+/*
+  ==============================================================================
+
+    ChainSettings.h
+
+    Parameter snapshot of the EQ chain and the filter design helpers shared
+    by the processor, the editor and the coefficient pipeline.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// One channel per SIMD lane, so a single pass through the cascade filters
+// several channels that share the same coefficients.
+using SIMDSample = juce::dsp::SIMDRegister<float>;
+
+enum ChainPositions {
+    LowCut,
+    PeakBand1,
+    PeakBand2,
+    HighCut,
+    FirstExtraBand      // "Band 5" onwards
+};
+
+constexpr int maxBands = 24;
+constexpr int numExtraBands = maxBands - FirstExtraBand;
+
+// In the order of the type parameters' choices.
+enum BandType {
+    LowShelf = 0,
+    HighShelf,
+    Bell,
+    Notch
+};
+
+// How the two channels of a stereo bus are presented to the bands.
+enum StereoMode {
+    LeftRight = 0,
+    MidSide
+};
+
+// Which channel of a stereo pair a band filters, in the order of the
+// placement parameters' choices. Buses that aren't stereo ignore it.
+enum BandPlacement {
+    BothChannels = 0,
+    FirstChannel,       // left, or mid
+    SecondChannel       // right, or side
+};
+
+enum Slope {
+    Slope_12dB = 0,
+    Slope_24dB,
+    Slope_36dB,
+    Slope_48dB
+};
+
+// Downward dynamics for a peak band: above the threshold, the band's gain
+// drops by (level - threshold) * (1 - 1 / ratio) dB.
+struct DynamicSettings {
+    bool enabled{ false };
+    float thresholdInDecibels{ -24.0f }, ratio{ 2.0f };
+    float attackMs{ 10.0f }, releaseMs{ 100.0f };
+};
+
+struct BandSettings {
+    bool enabled{ false };
+    BandType type{ Bell };
+    float frequency{ 1000 }, gainInDecibels{ 0 }, quality{ 0.71f };
+};
+
+struct ChainSettings {
+    float peak1Frequency{ 500 }, peak1GainInDecibels{ 0 }, peak1Quality{ 1.0f };
+    float peak2Frequency{ 2000 }, peak2GainInDecibels{ 0 }, peak2Quality{ 1.0f };
+    BandType peak1Type{ Bell }, peak2Type{ Bell };
+    DynamicSettings peak1Dynamics, peak2Dynamics;
+    bool dynamicsFromSidechain{ false };    // key from the sidechain bus instead of the band's own input
+    float lowCutFrequency{ 80 }, highCutFrequency{ 12000 };
+    Slope lowCutSlope{ Slope_12dB }, highCutSlope{ Slope_12dB };
+    float outputGain{ 0 };
+    bool bypass{ false };
+    bool linearPhase{ false };
+    int oversamplingOrder{ 0 };     // 0 = off, 1..3 = 2x..8x
+    std::array<BandSettings, numExtraBands> extraBands;    // chain positions FirstExtraBand onwards
+    StereoMode stereoMode{ LeftRight };
+    std::array<BandPlacement, maxBands> placements{};       // indexed by ChainPositions
+};
+
+// The two peak bands and the extra bands share one description; the peak
+// bands are always enabled. chainPosition must not be a cut band.
+BandSettings getBandSettings(const ChainSettings& chainSettings, int chainPosition) noexcept;
+
+// "Band5Freq" etc. for the extra bands, numbered from 1 like the editor shows them.
+juce::String getBandParameterID(int chainPosition, const juce::String& field);
+
+// "LowCutPlacement", "Peak1Placement", ... "Band5Placement" for every chain position.
+juce::String getPlacementParameterID(int chainPosition);
+
+ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts);
+
+// Reads a saved parameter tree (the format getStateInformation writes) without
+// needing a live AudioProcessorValueTreeState, e.g. for offline tools.
+ChainSettings getChainSettings(const juce::ValueTree& state);
+
+// Sets one field by its parameter ID. Returns false for unknown IDs.
+bool setChainSettingsParameter(ChainSettings& settings, const juce::String& parameterID, float value);
+
+// The rate the IIR cascade runs at, and so the rate its coefficients are designed for.
+double getProcessingSampleRate(const ChainSettings& chainSettings, double sampleRate) noexcept;
+
+juce::ReferenceCountedObjectPtr<juce::dsp::IIR::Coefficients<float>> makeBandFilter(const BandSettings& band, double sampleRate);
+
+std::pair<juce::ReferenceCountedObjectPtr<juce::dsp::IIR::Coefficients<float>>,
+    juce::ReferenceCountedObjectPtr<juce::dsp::IIR::Coefficients<float>>>
+    makePeakFilters(const ChainSettings& chainSettings, double sampleRate);
+
+inline auto makeLowCutFilter(const ChainSettings& chainSettings, double sampleRate) {
+    return juce::dsp::FilterDesign<float>::designIIRHighpassHighOrderButterworthMethod(
+        chainSettings.lowCutFrequency, sampleRate, 2 * (chainSettings.lowCutSlope + 1));
+};
+
+inline auto makeHighCutFilter(const ChainSettings& chainSettings, double sampleRate) {
+    return juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod(
+        chainSettings.highCutFrequency, sampleRate, 2 * (chainSettings.highCutSlope + 1));
+};
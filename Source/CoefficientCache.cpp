@@ -0,0 +1,205 @@
+/*
+  ==============================================================================
+
+    CoefficientCache.cpp
+
+  ==============================================================================
+*/
+
+#include "CoefficientCache.h"
+
+//==============================================================================
+FrequencyTable::FrequencyTable(double rate)
+    : sampleRate(rate) {
+    const auto numEntries = static_cast<size_t>(juce::roundToInt((maxFrequency - minFrequency) * stepsPerHz)) + 1;
+
+    sinHalf.resize(numEntries);
+    cosHalf.resize(numEntries);
+
+    for (size_t index = 0; index < numEntries; ++index) {
+        const double frequency = minFrequency + static_cast<double>(index) / stepsPerHz;
+        const double halfAngle = juce::MathConstants<double>::pi * frequency / sampleRate;
+
+        sinHalf[index] = static_cast<float>(std::sin(halfAngle));
+        cosHalf[index] = static_cast<float>(std::cos(halfAngle));
+    }
+}
+
+bool FrequencyTable::lookup(float frequency, float& sinHalfAngle, float& cosHalfAngle) const noexcept {
+    const int index = juce::roundToInt((frequency - minFrequency) * stepsPerHz);
+
+    if (index < 0 || static_cast<size_t>(index) >= sinHalf.size())
+        return false;
+
+    sinHalfAngle = sinHalf[static_cast<size_t>(index)];
+    cosHalfAngle = cosHalf[static_cast<size_t>(index)];
+    return true;
+}
+
+//==============================================================================
+namespace {
+    enum KeyType : juce::uint64 {
+        lowCutKey = 1,
+        highCutKey = 2,
+        firstBandKey = 3    // + BandType
+    };
+
+    // Field layout, from bit 0: sample rate in Hz (21 bits), frequency in
+    // steps (18), quality in steps or slope (10), gain in steps + 1024 (11),
+    // type (3). Bit 63 is always set so no key is 0.
+    juce::uint64 packKey(KeyType type, double sampleRate, float frequency, int shape, float gainInDecibels) noexcept {
+        const auto rate = static_cast<juce::uint64>(juce::jlimit(0, (1 << 21) - 1, juce::roundToInt(sampleRate)));
+        const auto steps = static_cast<juce::uint64>(juce::jlimit(0, (1 << 18) - 1, juce::roundToInt(frequency / CoefficientCache::frequencyStep)));
+        const auto shapeBits = static_cast<juce::uint64>(juce::jlimit(0, (1 << 10) - 1, shape));
+        const auto gain = static_cast<juce::uint64>(juce::jlimit(0, (1 << 11) - 1, juce::roundToInt(gainInDecibels / CoefficientCache::gainStep) + 1024));
+
+        return rate | (steps << 21) | (shapeBits << 39) | (gain << 49) | (static_cast<juce::uint64>(type) << 60) | (juce::uint64{ 1 } << 63);
+    }
+}
+
+float CoefficientCache::quantiseFrequency(float frequency) noexcept {
+    return static_cast<float>(juce::roundToInt(frequency / frequencyStep)) * frequencyStep;
+}
+
+float CoefficientCache::quantiseGain(float gainInDecibels) noexcept {
+    return static_cast<float>(juce::roundToInt(gainInDecibels / gainStep)) * gainStep;
+}
+
+float CoefficientCache::quantiseQuality(float quality) noexcept {
+    return static_cast<float>(juce::jmax(1, juce::roundToInt(quality / qualityStep))) * qualityStep;
+}
+
+juce::uint64 CoefficientCache::makeCutKey(bool isHighCut, double sampleRate, float frequency, Slope slope) noexcept {
+    return packKey(isHighCut ? highCutKey : lowCutKey, sampleRate, frequency, static_cast<int>(slope), 0.0f);
+}
+
+juce::uint64 CoefficientCache::makeBandKey(BandType type, double sampleRate, float frequency, float gainInDecibels, float quality) noexcept {
+    // A notch ignores its gain, so every gain shares one entry.
+    return packKey(static_cast<KeyType>(firstBandKey + static_cast<juce::uint64>(type)), sampleRate, frequency,
+        juce::roundToInt(quality / qualityStep), type == Notch ? 0.0f : gainInDecibels);
+}
+
+//==============================================================================
+CoefficientCache::CoefficientCache()
+    : entries(new Entry[capacity]) {
+    for (auto& table : tables)
+        table.store(nullptr);
+
+    tableModeEnabled.store(juce::SystemStats::getEnvironmentVariable("EQUALIZER_COEFFICIENT_TABLES", {}).getIntValue() != 0);
+}
+
+CoefficientCache::~CoefficientCache() = default;
+
+size_t CoefficientCache::getSlot(juce::uint64 key) noexcept {
+    static_assert(juce::isPowerOfTwo(capacity), "the slot mask needs a power-of-two capacity");
+    return static_cast<size_t>((key * 0x9e3779b97f4a7c15ull) >> 32) & static_cast<size_t>(capacity - 1);
+}
+
+bool CoefficientCache::lookup(juce::uint64 key, BandCoefficients& band) const noexcept {
+    const size_t first = getSlot(key);
+
+    for (int probe = 0; probe < maxProbes; ++probe) {
+        const Entry& entry = entries[(first + static_cast<size_t>(probe)) & static_cast<size_t>(capacity - 1)];
+
+        const auto sequence = entry.sequence.load(std::memory_order_acquire);
+        const auto entryKey = entry.key.load(std::memory_order_relaxed);
+
+        if (entryKey == 0)
+            break;
+
+        if (entryKey != key || (sequence & 1) != 0)
+            continue;
+
+        BandCoefficients copy = entry.band;
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        // A writer got in while copying: treat it as a miss rather than retry.
+        if (entry.sequence.load(std::memory_order_relaxed) != sequence)
+            break;
+
+        band = copy;
+        return true;
+    }
+
+    return false;
+}
+
+int CoefficientCache::getNumEntries() const noexcept {
+    int count = 0;
+
+    for (int slot = 0; slot < capacity; ++slot)
+        if (entries[static_cast<size_t>(slot)].key.load(std::memory_order_relaxed) != 0)
+            ++count;
+
+    return count;
+}
+
+void CoefficientCache::insert(juce::uint64 key, const BandCoefficients& band) noexcept {
+    const juce::SpinLock::ScopedTryLockType lock(writeLock);
+
+    if (!lock.isLocked())
+        return;
+
+    const size_t first = getSlot(key);
+    Entry* target = nullptr;
+
+    for (int probe = 0; probe < maxProbes && target == nullptr; ++probe) {
+        Entry& entry = entries[(first + static_cast<size_t>(probe)) & static_cast<size_t>(capacity - 1)];
+        const auto entryKey = entry.key.load(std::memory_order_relaxed);
+
+        if (entryKey == 0 || entryKey == key)
+            target = &entry;
+    }
+
+    // Probe chain full: evict round-robin so the cache stays bounded.
+    if (target == nullptr)
+        target = &entries[(first + (nextVictim++ % maxProbes)) & static_cast<size_t>(capacity - 1)];
+
+    const auto sequence = target->sequence.load(std::memory_order_relaxed);
+    target->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    target->key.store(key, std::memory_order_relaxed);
+    target->band = band;
+
+    target->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+//==============================================================================
+void CoefficientCache::prepareTable(double sampleRate) {
+    if (!isTableModeEnabled() || sampleRate <= 0.0 || findTable(sampleRate) != nullptr)
+        return;
+
+    const juce::ScopedLock lock(tableLock);
+
+    for (auto& table : tables) {
+        const FrequencyTable* existing = table.load(std::memory_order_acquire);
+
+        if (existing != nullptr && existing->sampleRate == sampleRate)
+            return;
+
+        if (existing == nullptr) {
+            table.store(tableStorage.add(new FrequencyTable(sampleRate)), std::memory_order_release);
+            return;
+        }
+    }
+
+    // Every slot is taken; misses at this rate fall back to computing the angles.
+}
+
+const FrequencyTable* CoefficientCache::findTable(double sampleRate) const noexcept {
+    if (!isTableModeEnabled())
+        return nullptr;
+
+    for (auto& table : tables) {
+        const FrequencyTable* candidate = table.load(std::memory_order_acquire);
+
+        if (candidate == nullptr)
+            return nullptr;
+
+        if (candidate->sampleRate == sampleRate)
+            return candidate;
+    }
+
+    return nullptr;
+}
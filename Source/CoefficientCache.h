@@ -0,0 +1,106 @@
+/*
+  ==============================================================================
+
+    CoefficientCache.h
+
+    Process-wide cache of designed bands, shared by every plugin instance
+    and editor through a SharedResourcePointer. Keys are the band
+    parameters quantised to their NormalisableRange steps plus the sample
+    rate. Lookups are wait-free (a sequence lock per entry); inserts never
+    block and give up if another thread is inserting. Optionally a
+    per-sample-rate table of prewarped angles makes cache misses cheap too,
+    e.g. during automation sweeps.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "EQCoefficients.h"
+
+//==============================================================================
+// sin and cos of half the digital angle (pi * f / fs) for every 0.1 Hz from
+// 20 Hz to 20 kHz: enough for both the RBJ peak and the bilinear cut designs.
+struct FrequencyTable {
+    static constexpr float minFrequency = 20.0f;
+    static constexpr float maxFrequency = 20000.0f;
+    static constexpr float stepsPerHz = 10.0f;
+
+    explicit FrequencyTable(double sampleRate);
+
+    // False if the frequency is outside the table.
+    bool lookup(float frequency, float& sinHalfAngle, float& cosHalfAngle) const noexcept;
+
+    const double sampleRate;
+    std::vector<float> sinHalf, cosHalf;
+};
+
+//==============================================================================
+class CoefficientCache {
+public:
+    static constexpr int capacity = 2048;
+    static constexpr int maxProbes = 8;
+    static constexpr int maxTables = 4;
+
+    // Quantisation steps, matching the intervals of the parameters' ranges.
+    static constexpr float frequencyStep = 0.1f;
+    static constexpr float gainStep = 0.1f;
+    static constexpr float qualityStep = 0.05f;
+
+    static float quantiseFrequency(float frequency) noexcept;
+    static float quantiseGain(float gainInDecibels) noexcept;
+    static float quantiseQuality(float quality) noexcept;
+
+    // Keys for quantised parameters; never 0, which marks an empty entry.
+    static juce::uint64 makeCutKey(bool isHighCut, double sampleRate, float frequency, Slope slope) noexcept;
+    static juce::uint64 makeBandKey(BandType type, double sampleRate, float frequency, float gainInDecibels, float quality) noexcept;
+
+    CoefficientCache();
+    ~CoefficientCache();
+
+    // Wait-free; safe on the audio thread.
+    bool lookup(juce::uint64 key, BandCoefficients& band) const noexcept;
+
+    // Never blocks. If another thread is inserting, this one is dropped.
+    void insert(juce::uint64 key, const BandCoefficients& band) noexcept;
+
+    // Table mode: off by default as each table takes ~1.6 MB. The plugin
+    // turns it on for the whole process when the EQUALIZER_COEFFICIENT_TABLES
+    // environment variable is non-zero, and then prepares a table for its
+    // processing rate in every prepareToPlay. prepareTable allocates and
+    // should be called from prepareToPlay or the message thread; with table
+    // mode off it does nothing.
+    void setTableModeEnabled(bool shouldBeEnabled) noexcept { tableModeEnabled.store(shouldBeEnabled); }
+    bool isTableModeEnabled() const noexcept { return tableModeEnabled.load(std::memory_order_relaxed); }
+    void prepareTable(double sampleRate);
+
+    // Wait-free. nullptr unless table mode is on and the rate has been prepared.
+    const FrequencyTable* findTable(double sampleRate) const noexcept;
+
+    // Filled slots, for reports. Every instance's audio thread looks bands up
+    // here, so the lookups themselves keep no counters: shared ones would
+    // put all of them on one contended cache line.
+    int getNumEntries() const noexcept;
+
+private:
+    struct Entry {
+        std::atomic<juce::uint32> sequence{ 0 };    // odd while being written
+        std::atomic<juce::uint64> key{ 0 };
+        BandCoefficients band;
+    };
+
+    static size_t getSlot(juce::uint64 key) noexcept;
+
+    std::unique_ptr<Entry[]> entries;
+    juce::SpinLock writeLock;
+    juce::uint32 nextVictim{ 0 };
+
+    // Tables are only ever added, so readers never see one freed.
+    std::atomic<bool> tableModeEnabled{ false };
+    juce::CriticalSection tableLock;
+    juce::OwnedArray<FrequencyTable> tableStorage;
+    std::array<std::atomic<const FrequencyTable*>, maxTables> tables;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CoefficientCache)
+};
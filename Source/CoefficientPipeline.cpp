@@ -0,0 +1,100 @@
+/*
+  ==============================================================================
+
+    CoefficientPipeline.cpp
+
+  ==============================================================================
+*/
+
+#include "CoefficientPipeline.h"
+
+CoefficientDesignThread::CoefficientDesignThread() : juce::TimeSliceThread("EQ Coefficient Designer") {
+    startThread();
+}
+
+CoefficientDesignThread::~CoefficientDesignThread() {
+    stopThread(1000);
+}
+
+//==============================================================================
+CoefficientPipeline::CoefficientPipeline(juce::AudioProcessorValueTreeState& state) : apvts(state) {
+    const auto& params = apvts.processor.getParameters();
+    for (auto param : params)
+        param->addListener(this);
+}
+
+CoefficientPipeline::~CoefficientPipeline() {
+    release();
+
+    const auto& params = apvts.processor.getParameters();
+    for (auto param : params)
+        param->removeListener(this);
+}
+
+void CoefficientPipeline::prepare(double sampleRate) {
+    currentSampleRate.store(sampleRate);
+    parametersChanged.store(false);
+
+    if (coefficientCache->isTableModeEnabled())
+        coefficientCache->prepareTable(getProcessingSampleRate(getChainSettings(apvts), sampleRate));
+    designAndPublish();
+
+    designThread->addTimeSliceClient(this);
+}
+
+void CoefficientPipeline::release() {
+    designThread->removeTimeSliceClient(this);
+}
+
+void CoefficientPipeline::requestUpdate() noexcept {
+    parametersChanged.store(true);
+}
+
+void CoefficientPipeline::setListener(Listener* newListener) {
+    const juce::ScopedLock sl(writerLock);
+    listener = newListener;
+}
+
+void CoefficientPipeline::parameterValueChanged(int parameterIndex, float newValue) {
+    // May be called from the audio thread during automation, so only raise a flag.
+    parametersChanged.store(true);
+}
+
+int CoefficientPipeline::useTimeSlice() {
+    if (parametersChanged.exchange(false))
+        designAndPublish();
+
+    return idleIntervalMs;
+}
+
+void CoefficientPipeline::designAndPublish() {
+    const double sampleRate = currentSampleRate.load();
+    if (sampleRate <= 0.0)
+        return;
+
+    EQCoefficients designed;
+
+    // Published before the lock is let go, so a set read from parameters
+    // that are about to be overwritten can't arrive after the new ones.
+    const juce::ScopedLock sl(writerLock);
+    {
+        const juce::ScopedLock pl(parameterLock);
+        const ChainSettings chainSettings = getChainSettings(apvts);
+        designed = designEQCoefficients(chainSettings, getProcessingSampleRate(chainSettings, sampleRate), coefficientCache);
+
+        slots[writeIndex] = designed;
+        writeIndex = middleIndex.exchange(writeIndex | freshFlag) & indexMask;
+    }
+
+    // After publishing, so slow listeners don't hold up the audio thread's copy.
+    if (listener != nullptr)
+        listener->coefficientsDesigned(designed);
+}
+
+const EQCoefficients* CoefficientPipeline::acquire() noexcept {
+    if ((middleIndex.load(std::memory_order_relaxed) & freshFlag) == 0)
+        return nullptr;
+
+    readIndex = middleIndex.exchange(readIndex) & indexMask;
+    return &slots[readIndex];
+}
@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    CoefficientPipeline.h
+
+    Watches the EQ parameters, redesigns the coefficients on a shared
+    background thread when something changes, and hands the newest set to
+    the audio thread through a wait-free triple buffer.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "EQCoefficients.h"
+#include "CoefficientCache.h"
+
+//==============================================================================
+// One low-priority thread shared by every plugin instance in the process.
+struct CoefficientDesignThread : juce::TimeSliceThread {
+    CoefficientDesignThread();
+    ~CoefficientDesignThread() override;
+};
+
+//==============================================================================
+class CoefficientPipeline : private juce::AudioProcessorParameter::Listener,
+                            private juce::TimeSliceClient
+{
+public:
+    // Told about every newly designed set, on whichever thread designed it
+    // (the design thread, or the caller of prepare).
+    struct Listener {
+        virtual ~Listener() = default;
+        virtual void coefficientsDesigned(const EQCoefficients& coefficients) = 0;
+    };
+
+    explicit CoefficientPipeline(juce::AudioProcessorValueTreeState& apvts);
+    ~CoefficientPipeline() override;
+
+    // Designs the current settings synchronously so the first block after
+    // prepareToPlay already has valid coefficients, then starts background updates.
+    void prepare(double sampleRate);
+    void release();
+
+    // Marks the parameters as changed, e.g. after a state restore.
+    void requestUpdate() noexcept;
+
+    void setListener(Listener* newListener);
+
+    // Held while the parameters are read and the set designed from them is
+    // published. Hold it while writing a whole state or preset so no set
+    // mixes old and new values.
+    const juce::CriticalSection& getParameterLock() const noexcept { return parameterLock; }
+
+    // Audio thread only. Returns the newest coefficient set if one has been
+    // published since the last call, otherwise nullptr. Never blocks or allocates.
+    const EQCoefficients* acquire() noexcept;
+
+private:
+    void parameterValueChanged(int parameterIndex, float newValue) override;
+    void parameterGestureChanged(int parameterIndex, bool gestureIsStarting) override {};
+
+    int useTimeSlice() override;
+
+    void designAndPublish();
+
+    static constexpr int idleIntervalMs = 5;
+    static constexpr int freshFlag = 4;
+    static constexpr int indexMask = 3;
+
+    juce::AudioProcessorValueTreeState& apvts;
+    juce::SharedResourcePointer<CoefficientDesignThread> designThread;
+    juce::SharedResourcePointer<CoefficientCache> coefficientCache;
+
+    std::atomic<double> currentSampleRate{ 0.0 };
+    std::atomic<bool> parametersChanged{ false };
+
+    // Triple buffer: the writer owns slots[writeIndex], the audio thread owns
+    // slots[readIndex], and the remaining slot is exchanged through middleIndex.
+    std::array<EQCoefficients, 3> slots;
+    juce::CriticalSection writerLock;
+    juce::CriticalSection parameterLock;
+    Listener* listener{ nullptr };
+    int writeIndex{ 0 };
+    int readIndex{ 1 };
+    std::atomic<int> middleIndex{ 2 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CoefficientPipeline)
+};
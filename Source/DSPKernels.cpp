@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+
+    DSPKernels.cpp
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "DSPKernels.h"
+#include "DSPKernelsImpl.h"
+
+// Defined in DSPKernelsAVX2.cpp and DSPKernelsAVX512.cpp; nullptr when the
+// build didn't enable the instruction set for them.
+const DSPKernels* getAVX2Kernels() noexcept;
+const DSPKernels* getAVX512Kernels() noexcept;
+
+static constexpr DSPKernels scalarKernels = makeKernels(DSPKernels::Scalar, "Scalar");
+
+static std::atomic<int> forcedVariant{ -1 };
+
+static bool canRun(DSPKernels::Variant variant) noexcept {
+    switch (variant) {
+        case DSPKernels::Scalar:
+            return true;
+
+        case DSPKernels::AVX2:
+            return juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3();
+
+        // What /arch:AVX512 and -mavx512f -mavx512vl -mavx512bw -mavx512dq may use.
+        case DSPKernels::AVX512:
+            return juce::SystemStats::hasAVX512F() && juce::SystemStats::hasAVX512VL()
+                && juce::SystemStats::hasAVX512BW() && juce::SystemStats::hasAVX512DQ()
+                && juce::SystemStats::hasFMA3();
+
+        case DSPKernels::numVariants:
+        default:
+            return false;
+    }
+}
+
+const DSPKernels* DSPKernels::get(Variant variant) noexcept {
+    const DSPKernels* kernels = nullptr;
+
+    switch (variant) {
+        case Scalar: kernels = &scalarKernels; break;
+        case AVX2: kernels = getAVX2Kernels(); break;
+        case AVX512: kernels = getAVX512Kernels(); break;
+        case numVariants:
+        default: break;
+    }
+
+    return kernels != nullptr && canRun(variant) ? kernels : nullptr;
+}
+
+const DSPKernels& DSPKernels::select() noexcept {
+    // Read on every call rather than cached, so a test can set it after startup.
+    int forced = forcedVariant.load(std::memory_order_relaxed);
+    if (forced < 0)
+        forced = findVariant(juce::SystemStats::getEnvironmentVariable("EQUALIZER_KERNELS", {}));
+
+    if (forced >= 0) {
+        if (const DSPKernels* kernels = get(static_cast<Variant>(forced)))
+            return *kernels;
+
+        // Not in this build or not on this CPU; carry on with the best one.
+        jassertfalse;
+    }
+
+    for (int variant = numVariants - 1; variant > Scalar; --variant)
+        if (const DSPKernels* kernels = get(static_cast<Variant>(variant)))
+            return *kernels;
+
+    return scalarKernels;
+}
+
+void DSPKernels::setForcedVariant(int variant) noexcept {
+    forcedVariant.store(juce::isPositiveAndBelow(variant, static_cast<int>(numVariants)) ? variant : -1, std::memory_order_relaxed);
+}
+
+int DSPKernels::findVariant(const juce::String& name) noexcept {
+    const juce::String trimmed = name.trim();
+
+    if (trimmed.equalsIgnoreCase("scalar")) return Scalar;
+    if (trimmed.equalsIgnoreCase("avx2"))   return AVX2;
+    if (trimmed.equalsIgnoreCase("avx512")) return AVX512;
+    return -1;
+}
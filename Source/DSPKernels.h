@@ -0,0 +1,97 @@
+/*
+  ==============================================================================
+
+    DSPKernels.h
+
+    The hot inner loops -- the biquad cascade, gain and crossfade, and the
+    response-curve evaluation -- compiled once per instruction set. The
+    portable build runs on every CPU; the AVX2 and AVX-512 builds come from
+    the same source in translation units of their own, compiled with those
+    instruction sets enabled, and are only handed out when the CPU has them.
+
+    Components pick a variant when they're prepared. The EQUALIZER_KERNELS
+    environment variable, or setForcedVariant, pins one for testing.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+// Nothing from JUCE here: the AVX builds include this header with their
+// instruction sets enabled, and any inline function they picked up could be
+// merged with the portable build's copy by the linker.
+namespace juce { class String; }
+
+//==============================================================================
+struct DSPKernels {
+    enum Variant {
+        Scalar = 0,
+        AVX2,
+        AVX512,
+        numVariants
+    };
+
+    // A BiquadCascade's coefficients and state, numLanes floats per section,
+    // filtering frames of numLanes interleaved channels. The lane count is
+    // the caller's SIMDSample::size(), which the AVX builds can't take from
+    // JUCE themselves: with AVX enabled it would be wider.
+    struct CascadeState {
+        const float* b0;
+        const float* b1;
+        const float* b2;
+        const float* a1;
+        const float* a2;
+        float* z1;
+        float* z2;
+        int numSections;
+        int numLanes;
+    };
+
+    // cos/sin of w and 2w for every grid point.
+    struct ResponseGrid {
+        const float* cosOmega;
+        const float* sinOmega;
+        const float* cos2Omega;
+        const float* sin2Omega;
+        int numPoints;
+    };
+
+    // Numerator and denominator of H(e^jw) for one section, and
+    // |numerator|^2 / |denominator|^2 with the numerator floored at 1e-30.
+    struct SectionResponse {
+        float* numeratorReal;
+        float* numeratorImag;
+        float* denominatorReal;
+        float* denominatorImag;
+        float* powerRatio;
+    };
+
+    Variant variant;
+    const char* name;
+
+    // Filters numSamples interleaved frames in place.
+    void (*cascade)(const CascadeState& state, float* samples, int numSamples) noexcept;
+
+    void (*gain)(float* samples, int numSamples, float gain) noexcept;
+
+    // wet = dry + (wet - dry) * gains, per sample.
+    void (*crossfade)(float* wet, const float* dry, const float* gains, int numSamples) noexcept;
+
+    // section holds b0, b1, b2, a1 and a2, normalised as in BiquadCoefficients.
+    void (*response)(const ResponseGrid& grid, const float* section, const SectionResponse& output) noexcept;
+
+    //==============================================================================
+    // The variant if this build contains it and the CPU can run it, otherwise nullptr.
+    static const DSPKernels* get(Variant variant) noexcept;
+
+    // The forced variant when there is one and it can run here, otherwise
+    // the fastest one that can. Never fails: Scalar is always there.
+    static const DSPKernels& select() noexcept;
+
+    // -1 lets select() choose. Takes precedence over EQUALIZER_KERNELS and
+    // applies to components prepared from then on.
+    static void setForcedVariant(int variant) noexcept;
+
+    // "scalar", "avx2" or "avx512", case-insensitive; -1 for anything else.
+    static int findVariant(const juce::String& name) noexcept;
+};
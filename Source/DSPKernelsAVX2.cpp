@@ -0,0 +1,31 @@
+/*
+  ==============================================================================
+
+    DSPKernelsAVX2.cpp
+
+    The AVX2 build of the kernels. The project compiles this file alone with
+    /arch:AVX2 (MSVC) or -mavx2 -mfma (GCC, Clang);
+    without them it contributes nothing and DSPKernels never offers it.
+
+  ==============================================================================
+*/
+
+#include "DSPKernels.h"
+
+#if defined(__AVX2__)
+
+#include "DSPKernelsImpl.h"
+
+static constexpr DSPKernels avx2Kernels = makeKernels(DSPKernels::AVX2, "AVX2");
+
+const DSPKernels* getAVX2Kernels() noexcept {
+    return &avx2Kernels;
+}
+
+#else
+
+const DSPKernels* getAVX2Kernels() noexcept {
+    return nullptr;
+}
+
+#endif
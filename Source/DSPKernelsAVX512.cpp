@@ -0,0 +1,31 @@
+/*
+  ==============================================================================
+
+    DSPKernelsAVX512.cpp
+
+    The AVX512 build of the kernels. The project compiles this file alone with
+    /arch:AVX512 (MSVC) or -mavx512f -mavx512vl -mavx512bw -mavx512dq -mfma;
+    without them it contributes nothing and DSPKernels never offers it.
+
+  ==============================================================================
+*/
+
+#include "DSPKernels.h"
+
+#if defined(__AVX512F__)
+
+#include "DSPKernelsImpl.h"
+
+static constexpr DSPKernels avx512Kernels = makeKernels(DSPKernels::AVX512, "AVX512");
+
+const DSPKernels* getAVX512Kernels() noexcept {
+    return &avx512Kernels;
+}
+
+#else
+
+const DSPKernels* getAVX512Kernels() noexcept {
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,154 @@
+/*
+  ==============================================================================
+
+    DSPKernelsImpl.h
+
+    The kernel bodies behind DSPKernels. Included by exactly one translation
+    unit per variant, each compiled for its own instruction set, so they're
+    plain loops left for the compiler to vectorise at that width.
+
+    Everything here has internal linkage and calls nothing inline from
+    elsewhere: a function emitted by more than one of these translation
+    units could otherwise be merged by the linker, and AVX code would end
+    up called on CPUs without it.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "DSPKernels.h"
+
+namespace {
+
+//==============================================================================
+// dsp::util::snapToZero, which BiquadCascade calls on its state, written out
+// since nothing from JUCE may be used here. Like JUCE's it only acts on Intel.
+inline void snapToZero(float& value) noexcept {
+   #if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+    if (!(value < -1.0e-8f || value > 1.0e-8f))
+        value = 0.0f;
+   #else
+    (void) value;
+   #endif
+}
+
+// Same operation order as BiquadCascade::processFused, including the flush of
+// tiny state at the end of each call, so the portable build matches it
+// exactly; the others differ only where they fuse multiply-adds.
+template <int lanes, int NumSections>
+void processFusedSections(const DSPKernels::CascadeState& state, int first, float* samples, int numSamples) noexcept {
+    float b0[NumSections][lanes], b1[NumSections][lanes], b2[NumSections][lanes], a1[NumSections][lanes], a2[NumSections][lanes];
+    float s1[NumSections][lanes], s2[NumSections][lanes];
+
+    for (int k = 0; k < NumSections; ++k) {
+        const int offset = (first + k) * lanes;
+
+        for (int lane = 0; lane < lanes; ++lane) {
+            b0[k][lane] = state.b0[offset + lane];
+            b1[k][lane] = state.b1[offset + lane];
+            b2[k][lane] = state.b2[offset + lane];
+            a1[k][lane] = state.a1[offset + lane];
+            a2[k][lane] = state.a2[offset + lane];
+            s1[k][lane] = state.z1[offset + lane];
+            s2[k][lane] = state.z2[offset + lane];
+        }
+    }
+
+    for (int i = 0; i < numSamples; ++i) {
+        float* frame = samples + i * lanes;
+
+        float x[lanes];
+        for (int lane = 0; lane < lanes; ++lane)
+            x[lane] = frame[lane];
+
+        for (int k = 0; k < NumSections; ++k) {
+            for (int lane = 0; lane < lanes; ++lane) {
+                const float y = (x[lane] * b0[k][lane]) + s1[k][lane];
+                s1[k][lane] = (x[lane] * b1[k][lane]) - (y * a1[k][lane]) + s2[k][lane];
+                s2[k][lane] = (x[lane] * b2[k][lane]) - (y * a2[k][lane]);
+                x[lane] = y;
+            }
+        }
+
+        for (int lane = 0; lane < lanes; ++lane)
+            frame[lane] = x[lane];
+    }
+
+    for (int k = 0; k < NumSections; ++k) {
+        const int offset = (first + k) * lanes;
+
+        for (int lane = 0; lane < lanes; ++lane) {
+            snapToZero(s1[k][lane]);
+            snapToZero(s2[k][lane]);
+            state.z1[offset + lane] = s1[k][lane];
+            state.z2[offset + lane] = s2[k][lane];
+        }
+    }
+}
+
+template <int lanes>
+void processCascadeLanes(const DSPKernels::CascadeState& state, float* samples, int numSamples) noexcept {
+    constexpr int maxFusedSections = 4;
+
+    for (int first = 0; first < state.numSections; first += maxFusedSections) {
+        const int remaining = state.numSections - first;
+
+        switch (remaining < maxFusedSections ? remaining : maxFusedSections) {
+            case 4: processFusedSections<lanes, 4>(state, first, samples, numSamples); break;
+            case 3: processFusedSections<lanes, 3>(state, first, samples, numSamples); break;
+            case 2: processFusedSections<lanes, 2>(state, first, samples, numSamples); break;
+            case 1: processFusedSections<lanes, 1>(state, first, samples, numSamples); break;
+            default: break;
+        }
+    }
+}
+
+// Four lanes for SSE and NEON builds, eight when JUCE itself was built for AVX.
+void processCascade(const DSPKernels::CascadeState& state, float* samples, int numSamples) noexcept {
+    switch (state.numLanes) {
+        case 1:  processCascadeLanes<1>(state, samples, numSamples); break;
+        case 2:  processCascadeLanes<2>(state, samples, numSamples); break;
+        case 4:  processCascadeLanes<4>(state, samples, numSamples); break;
+        case 8:  processCascadeLanes<8>(state, samples, numSamples); break;
+        case 16: processCascadeLanes<16>(state, samples, numSamples); break;
+        default: break;
+    }
+}
+
+void applyGain(float* samples, int numSamples, float gain) noexcept {
+    for (int i = 0; i < numSamples; ++i)
+        samples[i] *= gain;
+}
+
+void crossfade(float* wet, const float* dry, const float* gains, int numSamples) noexcept {
+    for (int i = 0; i < numSamples; ++i)
+        wet[i] = dry[i] + (wet[i] - dry[i]) * gains[i];
+}
+
+// H(e^jw) = (b0 + b1 e^-jw + b2 e^-2jw) / (1 + a1 e^-jw + a2 e^-2jw).
+void evaluateResponse(const DSPKernels::ResponseGrid& grid, const float* section, const DSPKernels::SectionResponse& output) noexcept {
+    const float b0 = section[0], b1 = section[1], b2 = section[2], a1 = section[3], a2 = section[4];
+
+    for (int point = 0; point < grid.numPoints; ++point) {
+        const float nr = b0 + b1 * grid.cosOmega[point] + b2 * grid.cos2Omega[point];
+        const float ni = 0.0f - (b1 * grid.sinOmega[point] + b2 * grid.sin2Omega[point]);
+        const float dr = 1.0f + a1 * grid.cosOmega[point] + a2 * grid.cos2Omega[point];
+        const float di = 0.0f - (a1 * grid.sinOmega[point] + a2 * grid.sin2Omega[point]);
+
+        const float numeratorPower = nr * nr + ni * ni;
+        const float denominatorPower = dr * dr + di * di;
+
+        output.numeratorReal[point] = nr;
+        output.numeratorImag[point] = ni;
+        output.denominatorReal[point] = dr;
+        output.denominatorImag[point] = di;
+        output.powerRatio[point] = (numeratorPower > 1.0e-30f ? numeratorPower : 1.0e-30f) / denominatorPower;
+    }
+}
+
+constexpr DSPKernels makeKernels(DSPKernels::Variant variant, const char* name) noexcept {
+    return { variant, name, processCascade, applyGain, crossfade, evaluateResponse };
+}
+
+} // namespace
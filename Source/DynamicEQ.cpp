@@ -0,0 +1,188 @@
+/*
+  ==============================================================================
+
+    DynamicEQ.cpp
+
+  ==============================================================================
+*/
+
+#include "DynamicEQ.h"
+#include "EQEngine.h"
+#include "SmoothedChainSettings.h"
+
+void DynamicEQ::prepare(double newSampleRate, int maximumBlockSize, int maxKeyChannels) {
+    sampleRate = newSampleRate;
+    numKeyChannels = juce::jmax(1, maxKeyChannels);
+
+    const int numLanes = numDynamicBands * numKeyChannels;
+    groups.assign(static_cast<size_t>((numLanes + laneWidth - 1) / laneWidth), LaneGroup());
+    keyLanes.assign(static_cast<size_t>(juce::jmax(0, maximumBlockSize)), SIMDSample::expand(0.0f));
+
+    updateLaneCoefficients();
+    reset();
+}
+
+void DynamicEQ::reset() noexcept {
+    for (LaneGroup& group : groups) {
+        group.s1 = SIMDSample::expand(0.0f);
+        group.s2 = SIMDSample::expand(0.0f);
+        group.envelope = SIMDSample::expand(0.0f);
+    }
+
+    gainReduction.fill(0.0f);
+}
+
+void DynamicEQ::setSettings(const ChainSettings& chainSettings, double processingSampleRate) noexcept {
+    const std::array<DynamicSettings, numDynamicBands> newSettings{ chainSettings.peak1Dynamics, chainSettings.peak2Dynamics };
+    const std::array<float, numDynamicBands> frequencies{ chainSettings.peak1Frequency, chainSettings.peak2Frequency };
+    const std::array<float, numDynamicBands> qualities{ chainSettings.peak1Quality, chainSettings.peak2Quality };
+    const std::array<BandType, numDynamicBands> types{ chainSettings.peak1Type, chainSettings.peak2Type };
+
+    bool detectorsChanged = false;
+    activeBands = 0;
+
+    for (size_t band = 0; band < numDynamicBands; ++band) {
+        detectorsChanged = detectorsChanged
+                        || frequencies[band] != detectorFrequency[band] || qualities[band] != detectorQuality[band]
+                        || newSettings[band].attackMs != settings[band].attackMs || newSettings[band].releaseMs != settings[band].releaseMs;
+
+        settings[band] = newSettings[band];
+        detectorFrequency[band] = frequencies[band];
+        detectorQuality[band] = qualities[band];
+        peakShapes[band] = makePeakShape(processingSampleRate, frequencies[band], qualities[band]);
+
+        // The gain-only update only knows the bell's shape.
+        if (settings[band].enabled && types[band] == Bell)
+            activeBands |= 1 << band;
+        else
+            gainReduction[band] = 0.0f;
+    }
+
+    if (detectorsChanged)
+        updateLaneCoefficients();
+}
+
+void DynamicEQ::updateLaneCoefficients() noexcept {
+    if (sampleRate <= 0.0)
+        return;
+
+    for (size_t groupIndex = 0; groupIndex < groups.size(); ++groupIndex) {
+        LaneGroup& group = groups[groupIndex];
+
+        for (int lane = 0; lane < laneWidth; ++lane) {
+            const int band = juce::jmin(numDynamicBands - 1, (static_cast<int>(groupIndex) * laneWidth + lane) / numKeyChannels);
+            const DynamicSettings& bandSettings = settings[static_cast<size_t>(band)];
+
+            // RBJ constant 0 dB peak band-pass around the band's centre.
+            const double frequency = juce::jlimit(10.0, sampleRate * 0.45, static_cast<double>(detectorFrequency[static_cast<size_t>(band)]));
+            const double omega = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+            const double alpha = std::sin(omega) / (2.0 * juce::jmax(0.1f, detectorQuality[static_cast<size_t>(band)]));
+            const double a0Inverse = 1.0 / (1.0 + alpha);
+
+            group.b0.set(static_cast<size_t>(lane), static_cast<float>(alpha * a0Inverse));
+            group.b2.set(static_cast<size_t>(lane), static_cast<float>(-alpha * a0Inverse));
+            group.a1.set(static_cast<size_t>(lane), static_cast<float>(-2.0 * std::cos(omega) * a0Inverse));
+            group.a2.set(static_cast<size_t>(lane), static_cast<float>((1.0 - alpha) * a0Inverse));
+
+            group.attack.set(static_cast<size_t>(lane), static_cast<float>(std::exp(-1000.0 / (juce::jmax(0.01f, bandSettings.attackMs) * sampleRate))));
+            group.release.set(static_cast<size_t>(lane), static_cast<float>(std::exp(-1000.0 / (juce::jmax(0.01f, bandSettings.releaseMs) * sampleRate))));
+        }
+    }
+}
+
+void DynamicEQ::analyse(const juce::dsp::AudioBlock<const float>& key) {
+    if (activeBands == 0)
+        return;
+
+    const int numSamples = juce::jmin(static_cast<int>(key.getNumSamples()), static_cast<int>(keyLanes.size()));
+    const int numLanes = numDynamicBands * numKeyChannels;
+    float* lanes = reinterpret_cast<float*>(keyLanes.data());
+
+    std::array<float, numDynamicBands> loudest{};
+
+    for (size_t groupIndex = 0; groupIndex < groups.size(); ++groupIndex) {
+        LaneGroup& group = groups[groupIndex];
+
+        // Every band listens to every key channel, so the key is gathered once per lane.
+        for (int lane = 0; lane < laneWidth; ++lane) {
+            const int globalLane = static_cast<int>(groupIndex) * laneWidth + lane;
+            const int channel = globalLane % numKeyChannels;
+
+            if (globalLane < numLanes && channel < static_cast<int>(key.getNumChannels())) {
+                const float* input = key.getChannelPointer(static_cast<size_t>(channel));
+                for (int sample = 0; sample < numSamples; ++sample)
+                    lanes[sample * laneWidth + lane] = input[sample];
+            }
+            else {
+                for (int sample = 0; sample < numSamples; ++sample)
+                    lanes[sample * laneWidth + lane] = 0.0f;
+            }
+        }
+
+        SIMDSample s1 = group.s1, s2 = group.s2, envelope = group.envelope;
+        const SIMDSample attackMinusRelease = group.attack - group.release;
+
+        for (int sample = 0; sample < numSamples; ++sample) {
+            const SIMDSample x = keyLanes[static_cast<size_t>(sample)];
+            const SIMDSample y = (x * group.b0) + s1;
+            s1 = s2 - (y * group.a1);
+            s2 = (x * group.b2) - (y * group.a2);
+
+            // Attack coefficient while the level rises above the envelope, release otherwise.
+            const SIMDSample level = SIMDSample::abs(y);
+            const SIMDSample coefficient = group.release + (attackMinusRelease & SIMDSample::greaterThan(level, envelope));
+            envelope = level + ((envelope - level) * coefficient);
+        }
+
+        juce::dsp::util::snapToZero(s1);
+        juce::dsp::util::snapToZero(s2);
+        group.s1 = s1;
+        group.s2 = s2;
+        group.envelope = envelope;
+
+        for (int lane = 0; lane < laneWidth; ++lane) {
+            const int globalLane = static_cast<int>(groupIndex) * laneWidth + lane;
+            if (globalLane < numLanes) {
+                float& bandLevel = loudest[static_cast<size_t>(globalLane / numKeyChannels)];
+                bandLevel = juce::jmax(bandLevel, envelope.get(static_cast<size_t>(lane)));
+            }
+        }
+    }
+
+    for (size_t band = 0; band < numDynamicBands; ++band) {
+        if ((activeBands & (1 << band)) == 0)
+            continue;
+
+        const float over = juce::Decibels::gainToDecibels(loudest[band], -120.0f) - settings[band].thresholdInDecibels;
+        const float slope = 1.0f - 1.0f / juce::jmax(1.0f, settings[band].ratio);
+        gainReduction[band] = juce::jlimit(0.0f, maxReductionInDecibels, over * slope);
+    }
+}
+
+BiquadCoefficients DynamicEQ::getPeakSection(int dynamicBand, float staticGainInDecibels) const noexcept {
+    return makePeakBiquad(peakShapes[static_cast<size_t>(dynamicBand)], staticGainInDecibels - gainReduction[static_cast<size_t>(dynamicBand)]);
+}
+
+void DynamicEQ::processSubBlock(EQEngine& engine, const ChainSettings& chainSettings, const juce::dsp::AudioBlock<float>& block,
+                                const juce::dsp::AudioBlock<const float>& key) {
+    analyse(key);
+
+    // Only the one peak section is swapped: the gain-only update reuses the
+    // band's angle terms, so there is no full redesign.
+    const std::array<float, numDynamicBands> staticGains{ chainSettings.peak1GainInDecibels, chainSettings.peak2GainInDecibels };
+
+    for (int band = 0; band < numDynamicBands; ++band)
+        if (isBandActive(band))
+            engine.setBandSection(getChainPosition(band), 0, getPeakSection(band, staticGains[static_cast<size_t>(band)]));
+
+    engine.process(block);
+}
+
+void DynamicEQ::process(EQEngine& engine, const ChainSettings& chainSettings, const juce::dsp::AudioBlock<float>& block) {
+    const int numSamples = static_cast<int>(block.getNumSamples());
+
+    for (int start = 0; start < numSamples; start += SmoothedChainSettings::subBlockSize) {
+        const juce::dsp::AudioBlock<float> subBlock = block.getSubBlock(static_cast<size_t>(start), static_cast<size_t>(juce::jmin(SmoothedChainSettings::subBlockSize, numSamples - start)));
+        processSubBlock(engine, chainSettings, subBlock, subBlock);
+    }
+}
@@ -0,0 +1,89 @@
+/*
+  ==============================================================================
+
+    DynamicEQ.h
+
+    Gain computers for the dynamic peak bands. Every (band, key channel)
+    pair is one SIMD lane: the key is band-passed around the band's centre
+    and followed by an attack/release envelope, all lanes of a group in one
+    vectorised pass. The channels of a band are linked by taking the
+    loudest, and the resulting gain is turned into new peak coefficients
+    once per sub-block through the gain-only closed-form update.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ChainSettings.h"
+#include "EQCoefficients.h"
+
+class EQEngine;
+
+//==============================================================================
+class DynamicEQ {
+public:
+    static constexpr int numDynamicBands = 2;     // the two peak bands
+    static constexpr int laneWidth = static_cast<int>(SIMDSample::size());
+    static constexpr float maxReductionInDecibels = 24.0f;
+
+    DynamicEQ() = default;
+
+    // Allocates the detector lanes. Not realtime safe.
+    void prepare(double sampleRate, int maximumBlockSize, int maxKeyChannels);
+    void reset() noexcept;
+
+    // Redesigns the detectors at the base rate and the peak shapes at
+    // processingSampleRate. A few trig calls per band; realtime safe.
+    void setSettings(const ChainSettings& chainSettings, double processingSampleRate) noexcept;
+
+    bool isActive() const noexcept { return activeBands != 0; }
+    bool isBandActive(int dynamicBand) const noexcept { return (activeBands & (1 << dynamicBand)) != 0; }
+
+    // Runs the envelope followers over the key. Channels beyond those
+    // prepared for are ignored, missing ones count as silence.
+    void analyse(const juce::dsp::AudioBlock<const float>& key);
+
+    // Current reduction of a band, >= 0 dB.
+    float getGainReduction(int dynamicBand) const noexcept { return gainReduction[static_cast<size_t>(dynamicBand)]; }
+
+    // The band's peak section with staticGainInDecibels lowered by the current reduction.
+    BiquadCoefficients getPeakSection(int dynamicBand, float staticGainInDecibels) const noexcept;
+
+    static int getChainPosition(int dynamicBand) noexcept { return dynamicBand == 0 ? ChainPositions::PeakBand1 : ChainPositions::PeakBand2; }
+
+    // One sub-block: analyses the key, swaps each active band's peak section
+    // in the engine for one at its current reduction, then filters the block.
+    // chainSettings supplies the peak bands' static gains.
+    void processSubBlock(EQEngine& engine, const ChainSettings& chainSettings, const juce::dsp::AudioBlock<float>& block,
+                         const juce::dsp::AudioBlock<const float>& key);
+
+    // The whole block on the plugin's SmoothedChainSettings::subBlockSize
+    // grid, keyed from the block itself.
+    void process(EQEngine& engine, const ChainSettings& chainSettings, const juce::dsp::AudioBlock<float>& block);
+
+private:
+    // Lane l of the whole detector is band l / numKeyChannels, channel l % numKeyChannels.
+    struct LaneGroup {
+        SIMDSample b0, b2, a1, a2;      // band-pass, so b1 == 0
+        SIMDSample attack, release;
+        SIMDSample s1, s2, envelope;
+    };
+
+    void updateLaneCoefficients() noexcept;
+
+    std::vector<LaneGroup> groups;
+    int numKeyChannels{ 0 };
+    std::vector<SIMDSample> keyLanes;
+
+    double sampleRate{ 0.0 };
+    int activeBands{ 0 };
+
+    std::array<DynamicSettings, numDynamicBands> settings;
+    std::array<float, numDynamicBands> detectorFrequency{}, detectorQuality{};
+    std::array<PeakShape, numDynamicBands> peakShapes;
+    std::array<float, numDynamicBands> gainReduction{};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DynamicEQ)
+};
@@ -0,0 +1,339 @@
+/*
+  ==============================================================================
+
+    EQCoefficients.cpp
+
+  ==============================================================================
+*/
+
+#include "EQCoefficients.h"
+#include "CoefficientCache.h"
+
+BiquadCoefficients toBiquadCoefficients(const juce::dsp::IIR::Coefficients<float>& coefficients) {
+    // Every section in this EQ is second order; first-order designs would need their own layout.
+    jassert(coefficients.coefficients.size() == 5);
+
+    BiquadCoefficients biquad;
+    biquad.b0 = coefficients.coefficients.getUnchecked(0);
+    biquad.b1 = coefficients.coefficients.getUnchecked(1);
+    biquad.b2 = coefficients.coefficients.getUnchecked(2);
+    biquad.a1 = coefficients.coefficients.getUnchecked(3);
+    biquad.a2 = coefficients.coefficients.getUnchecked(4);
+    return biquad;
+}
+
+static void setCutBandCoefficients(BandCoefficients& band, const juce::ReferenceCountedArray<juce::dsp::IIR::Coefficients<float>>& coefficients, Slope slope) {
+    band.numSections = juce::jmin(static_cast<int>(slope) + 1, coefficients.size(), BandCoefficients::maxSections);
+
+    for (int stage = 0; stage < band.numSections; ++stage)
+        band.sections[stage] = toBiquadCoefficients(*coefficients.getObjectPointerUnchecked(stage));
+}
+
+// Bands that are off, and shelves and bells at 0 dB, get no sections at all.
+// A dynamic bell keeps its section even when flat: the reduction moves it.
+static bool isBandAudible(const ChainSettings& chainSettings, const BandSettings& band, int chainPosition) noexcept {
+    const bool isDynamic = (chainPosition == ChainPositions::PeakBand1 && chainSettings.peak1Dynamics.enabled)
+                        || (chainPosition == ChainPositions::PeakBand2 && chainSettings.peak2Dynamics.enabled);
+
+    if (isDynamic && band.type == Bell)
+        return true;
+
+    return band.enabled && (band.type == Notch || band.gainInDecibels != 0.0f);
+}
+
+static bool isCutAudible(double sampleRate, float frequency, bool isHighPass) noexcept {
+    if (isHighPass)
+        return frequency > lowCutOffFrequency;
+
+    return frequency < juce::jmin(highCutOffFrequency, static_cast<float>(sampleRate * 0.5));
+}
+
+static void compactActiveBands(EQCoefficients& coefficients) noexcept {
+    coefficients.numActiveBands = 0;
+
+    for (int position = 0; position < EQCoefficients::numBands; ++position)
+        if (coefficients.bands[position].numSections > 0)
+            coefficients.activeBands[coefficients.numActiveBands++] = position;
+}
+
+EQCoefficients designEQCoefficients(const ChainSettings& chainSettings, double sampleRate, CoefficientCache* cache) {
+    EQCoefficients result;
+    result.settings = chainSettings;
+    result.sampleRate = sampleRate;
+
+    if (sampleRate <= 0.0)
+        return result;
+
+    if (cache != nullptr) {
+        updateEQCoefficients(result, chainSettings, sampleRate, EQCoefficients::allBandsMask, cache);
+        return result;
+    }
+
+    for (int position = ChainPositions::PeakBand1; position < EQCoefficients::numBands; ++position) {
+        if (position == ChainPositions::HighCut)
+            continue;
+
+        const BandSettings band = getBandSettings(chainSettings, position);
+        if (!isBandAudible(chainSettings, band, position))
+            continue;
+
+        result.bands[position].sections[0] = toBiquadCoefficients(*makeBandFilter(band, sampleRate));
+        result.bands[position].numSections = 1;
+    }
+
+    if (isCutAudible(sampleRate, chainSettings.lowCutFrequency, true))
+        setCutBandCoefficients(result.bands[ChainPositions::LowCut], makeLowCutFilter(chainSettings, sampleRate), chainSettings.lowCutSlope);
+
+    if (isCutAudible(sampleRate, chainSettings.highCutFrequency, false))
+        setCutBandCoefficients(result.bands[ChainPositions::HighCut], makeHighCutFilter(chainSettings, sampleRate), chainSettings.highCutSlope);
+
+    compactActiveBands(result);
+    return result;
+}
+
+double getTailLengthSamples(const EQCoefficients& coefficients, double decayInDecibels) noexcept {
+    double slowestRadius = 0.0;
+
+    for (int index = 0; index < coefficients.numActiveBands; ++index) {
+        const BandCoefficients& band = coefficients.bands[coefficients.activeBands[index]];
+
+        for (int section = 0; section < band.numSections; ++section) {
+            const double a1 = band.sections[section].a1;
+            const double a2 = band.sections[section].a2;
+            const double discriminant = a1 * a1 - 4.0 * a2;
+
+            // Poles of z^2 + a1 z + a2: a conjugate pair of radius sqrt(a2), or two real ones.
+            const double radius = discriminant < 0.0 ? std::sqrt(a2) : 0.5 * (std::abs(a1) + std::sqrt(discriminant));
+            slowestRadius = juce::jmax(slowestRadius, radius);
+        }
+    }
+
+    if (slowestRadius <= 0.0)
+        return 0.0;
+
+    if (slowestRadius >= 1.0)
+        return std::numeric_limits<double>::infinity();
+
+    // r^n == 10^(-dB / 20)
+    return decayInDecibels * std::log(10.0) / 20.0 / -std::log(slowestRadius);
+}
+
+//==============================================================================
+static BiquadCoefficients makeNormalisedBiquad(float b0, float b1, float b2, float a0, float a1, float a2) noexcept {
+    const float a0Inverse = 1.0f / a0;
+    return { b0 * a0Inverse, b1 * a0Inverse, b2 * a0Inverse, a1 * a0Inverse, a2 * a0Inverse };
+}
+
+static BiquadCoefficients makePeakBiquadFromAngle(float sinOmega, float cosOmega, float quality, float gainFactor) noexcept {
+    const float A = juce::jmax(0.0f, std::sqrt(gainFactor));
+    const float alpha = sinOmega / (quality * 2.0f);
+    const float c2 = -2.0f * cosOmega;
+    const float alphaTimesA = alpha * A;
+    const float alphaOverA = alpha / A;
+
+    return makeNormalisedBiquad(1.0f + alphaTimesA, c2, 1.0f - alphaTimesA, 1.0f + alphaOverA, c2, 1.0f - alphaOverA);
+}
+
+// n is cot(pi * frequency / sampleRate). IIR::Coefficients::makeNotch's
+// expressions in its order, so the result matches it bit for bit.
+static BiquadCoefficients makeNotchBiquad(float n, float quality) noexcept {
+    const float nSquared = n * n;
+    const float invQ = 1.0f / quality;
+    const float c1 = 1.0f / (1.0f + n * invQ + nSquared);
+    const float b0 = c1 * (1.0f + nSquared);
+    const float b1 = 2.0f * c1 * (1.0f - nSquared);
+
+    return { b0, b1, b0, b1, c1 * (1.0f - n * invQ + nSquared) };
+}
+
+// Shelves and bells; notches are designed from the half angle instead.
+static BiquadCoefficients makeBiquadFromAngle(BandType type, float sinOmega, float cosOmega, float quality, float gainFactor) noexcept {
+    switch (type) {
+        case LowShelf:
+        case HighShelf: {
+            const float A = juce::jmax(0.0f, std::sqrt(gainFactor));
+            const float aMinus1 = A - 1.0f;
+            const float aPlus1 = A + 1.0f;
+            const float beta = sinOmega * std::sqrt(A) / quality;
+            const float aMinus1TimesCos = aMinus1 * cosOmega;
+
+            if (type == LowShelf)
+                return makeNormalisedBiquad(A * (aPlus1 - aMinus1TimesCos + beta), A * 2.0f * (aMinus1 - aPlus1 * cosOmega), A * (aPlus1 - aMinus1TimesCos - beta),
+                                            aPlus1 + aMinus1TimesCos + beta, -2.0f * (aMinus1 + aPlus1 * cosOmega), aPlus1 + aMinus1TimesCos - beta);
+
+            return makeNormalisedBiquad(A * (aPlus1 + aMinus1TimesCos + beta), A * -2.0f * (aMinus1 + aPlus1 * cosOmega), A * (aPlus1 + aMinus1TimesCos - beta),
+                                        aPlus1 - aMinus1TimesCos + beta, 2.0f * (aMinus1 - aPlus1 * cosOmega), aPlus1 - aMinus1TimesCos - beta);
+        }
+
+        case Bell:
+        default:
+            return makePeakBiquadFromAngle(sinOmega, cosOmega, quality, gainFactor);
+    }
+}
+
+BiquadCoefficients makeBandBiquad(BandType type, double sampleRate, float frequency, float quality, float gainFactor) noexcept {
+    if (type == Notch)
+        return makeNotchBiquad(1.0f / std::tan(juce::MathConstants<float>::pi * frequency / static_cast<float>(sampleRate)), quality);
+
+    const float omega = (2.0f * juce::MathConstants<float>::pi * juce::jmax(frequency, 2.0f)) / static_cast<float>(sampleRate);
+    return makeBiquadFromAngle(type, std::sin(omega), std::cos(omega), quality, gainFactor);
+}
+
+BiquadCoefficients makePeakBiquad(double sampleRate, float frequency, float quality, float gainFactor) noexcept {
+    return makeBandBiquad(Bell, sampleRate, frequency, quality, gainFactor);
+}
+
+PeakShape makePeakShape(double sampleRate, float frequency, float quality) noexcept {
+    const float omega = (2.0f * juce::MathConstants<float>::pi * juce::jmax(frequency, 2.0f)) / static_cast<float>(sampleRate);
+    return { std::sin(omega) / (quality * 2.0f), -2.0f * std::cos(omega) };
+}
+
+BiquadCoefficients makePeakBiquad(const PeakShape& shape, float gainInDecibels) noexcept {
+    // sqrt of the gain factor: 10^(dB / 40).
+    const float A = std::exp(gainInDecibels * (2.302585093f / 40.0f));
+    const float alphaTimesA = shape.alpha * A;
+    const float alphaOverA = shape.alpha / A;
+
+    return makeNormalisedBiquad(1.0f + alphaTimesA, shape.c2, 1.0f - alphaTimesA, 1.0f + alphaOverA, shape.c2, 1.0f - alphaOverA);
+}
+
+static float getButterworthQuality(int order, int stage) noexcept {
+    return static_cast<float>(1.0 / (2.0 * std::cos((2.0 * stage + 1.0) * juce::MathConstants<double>::pi / (order * 2.0))));
+}
+
+// t is tan(pi * frequency / sampleRate). The sections are built with the
+// expressions IIR::Coefficients' makeHighPass and makeLowPass use, in the
+// same order, so an exact t gives FilterDesign's cascade bit for bit: the
+// high pass works in t itself and the low pass in its reciprocal.
+static void makeCutBand(BandCoefficients& band, float t, Slope slope, bool isHighPass) noexcept {
+    const int order = 2 * (static_cast<int>(slope) + 1);
+    const float n = isHighPass ? t : 1.0f / t;
+    const float nSquared = n * n;
+
+    band.numSections = order / 2;
+
+    for (int stage = 0; stage < band.numSections; ++stage) {
+        const float invQ = 1.0f / getButterworthQuality(order, stage);
+        const float c1 = 1.0f / (1.0f + invQ * n + nSquared);
+        BiquadCoefficients& section = band.sections[stage];
+
+        section.b0 = c1;
+        section.b2 = c1;
+
+        if (isHighPass) {
+            section.b1 = c1 * -2.0f;
+            section.a1 = c1 * 2.0f * (nSquared - 1.0f);
+        }
+        else {
+            section.b1 = c1 * 2.0f;
+            section.a1 = c1 * 2.0f * (1.0f - nSquared);
+        }
+
+        section.a2 = c1 * (1.0f - invQ * n + nSquared);
+    }
+}
+
+static void makeCutBand(BandCoefficients& band, double sampleRate, float frequency, Slope slope, bool isHighPass) noexcept {
+    makeCutBand(band, std::tan(juce::MathConstants<float>::pi * frequency / static_cast<float>(sampleRate)), slope, isHighPass);
+}
+
+void makeLowCutBand(BandCoefficients& band, double sampleRate, float frequency, Slope slope) noexcept {
+    makeCutBand(band, sampleRate, frequency, slope, true);
+}
+
+void makeHighCutBand(BandCoefficients& band, double sampleRate, float frequency, Slope slope) noexcept {
+    makeCutBand(band, sampleRate, frequency, slope, false);
+}
+
+//==============================================================================
+// Cached designs use the quantised parameters, so the result is the same
+// whether it came from the cache, the angle table or a fresh design.
+static void designCutBand(BandCoefficients& band, double sampleRate, float frequency, Slope slope, bool isHighPass,
+    CoefficientCache* cache) noexcept {
+    if (!isCutAudible(sampleRate, frequency, isHighPass)) {
+        band.numSections = 0;
+        return;
+    }
+
+    if (cache == nullptr) {
+        makeCutBand(band, sampleRate, frequency, slope, isHighPass);
+        return;
+    }
+
+    frequency = CoefficientCache::quantiseFrequency(frequency);
+    const juce::uint64 key = CoefficientCache::makeCutKey(!isHighPass, sampleRate, frequency, slope);
+
+    if (cache->lookup(key, band))
+        return;
+
+    float sinHalfAngle, cosHalfAngle;
+    const FrequencyTable* table = cache->findTable(sampleRate);
+
+    if (table != nullptr && table->lookup(frequency, sinHalfAngle, cosHalfAngle))
+        makeCutBand(band, sinHalfAngle / cosHalfAngle, slope, isHighPass);
+    else
+        makeCutBand(band, sampleRate, frequency, slope, isHighPass);
+
+    cache->insert(key, band);
+}
+
+static void designBand(BandCoefficients& band, double sampleRate, const ChainSettings& chainSettings, int chainPosition,
+    CoefficientCache* cache) noexcept {
+    const BandSettings settings = getBandSettings(chainSettings, chainPosition);
+
+    if (!isBandAudible(chainSettings, settings, chainPosition)) {
+        band.numSections = 0;
+        return;
+    }
+
+    band.numSections = 1;
+
+    if (cache == nullptr) {
+        band.sections[0] = makeBandBiquad(settings.type, sampleRate, settings.frequency, settings.quality,
+            juce::Decibels::decibelsToGain(settings.gainInDecibels));
+        return;
+    }
+
+    const float frequency = CoefficientCache::quantiseFrequency(settings.frequency);
+    const float quality = CoefficientCache::quantiseQuality(settings.quality);
+    const float gainInDecibels = CoefficientCache::quantiseGain(settings.gainInDecibels);
+    const juce::uint64 key = CoefficientCache::makeBandKey(settings.type, sampleRate, frequency, gainInDecibels, quality);
+
+    if (cache->lookup(key, band))
+        return;
+
+    const float gainFactor = juce::Decibels::decibelsToGain(gainInDecibels);
+    float sinHalfAngle, cosHalfAngle;
+    const FrequencyTable* table = cache->findTable(sampleRate);
+
+    // The band's angle is twice the table's half angle.
+    if (table == nullptr || !table->lookup(frequency, sinHalfAngle, cosHalfAngle))
+        band.sections[0] = makeBandBiquad(settings.type, sampleRate, frequency, quality, gainFactor);
+    else if (settings.type == Notch)
+        band.sections[0] = makeNotchBiquad(cosHalfAngle / sinHalfAngle, quality);
+    else
+        band.sections[0] = makeBiquadFromAngle(settings.type, 2.0f * sinHalfAngle * cosHalfAngle, 1.0f - 2.0f * sinHalfAngle * sinHalfAngle, quality, gainFactor);
+
+    cache->insert(key, band);
+}
+
+void updateEQCoefficients(EQCoefficients& coefficients, const ChainSettings& chainSettings, double sampleRate, int bandMask,
+    CoefficientCache* cache) noexcept {
+    coefficients.settings = chainSettings;
+    coefficients.sampleRate = sampleRate;
+
+    if (sampleRate <= 0.0)
+        return;
+
+    if (bandMask & (1 << ChainPositions::LowCut))
+        designCutBand(coefficients.bands[ChainPositions::LowCut], sampleRate, chainSettings.lowCutFrequency, chainSettings.lowCutSlope, true, cache);
+
+    if (bandMask & (1 << ChainPositions::HighCut))
+        designCutBand(coefficients.bands[ChainPositions::HighCut], sampleRate, chainSettings.highCutFrequency, chainSettings.highCutSlope, false, cache);
+
+    for (int position = ChainPositions::PeakBand1; position < EQCoefficients::numBands; ++position)
+        if (position != ChainPositions::HighCut && (bandMask & (1 << position)))
+            designBand(coefficients.bands[position], sampleRate, chainSettings, position, cache);
+
+    compactActiveBands(coefficients);
+}
@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+
+    EQCoefficients.h
+
+    Plain-value coefficient sets for the whole EQ chain. These are designed
+    off the audio thread and copied into the filters without allocating.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ChainSettings.h"
+
+class CoefficientCache;
+
+//==============================================================================
+// Normalised biquad (a0 == 1), in the same order JUCE stores second-order
+// IIR::Coefficients: b0, b1, b2, a1, a2.
+struct BiquadCoefficients {
+    float b0{ 1.0f }, b1{ 0.0f }, b2{ 0.0f }, a1{ 0.0f }, a2{ 0.0f };
+};
+
+struct BandCoefficients {
+    static constexpr int maxSections = 4;
+
+    std::array<BiquadCoefficients, maxSections> sections;
+    int numSections{ 0 };
+};
+
+// Cuts parked at the edge of the audio range are designed as switched off.
+constexpr float lowCutOffFrequency = 20.0f;
+constexpr float highCutOffFrequency = 20000.0f;
+
+struct EQCoefficients {
+    static constexpr int numBands = maxBands;
+    static constexpr int allBandsMask = (1 << numBands) - 1;
+
+    // Only the two cut bands ever need more than one section.
+    static constexpr int maxTotalSections = 2 * BandCoefficients::maxSections + (numBands - 2);
+
+    ChainSettings settings;
+    double sampleRate{ 0.0 };
+    std::array<BandCoefficients, numBands> bands;    // indexed by ChainPositions
+
+    // Bands with at least one section, in chain order. Disabled, flat and
+    // out-of-band bands are left out, so nothing downstream spends time on them.
+    std::array<int, numBands> activeBands{};
+    int numActiveBands{ 0 };
+};
+
+BiquadCoefficients toBiquadCoefficients(const juce::dsp::IIR::Coefficients<float>& coefficients);
+
+// With a cache, bands are designed closed-form at the cache's quantised
+// parameter values and shared with every other user of that cache.
+EQCoefficients designEQCoefficients(const ChainSettings& chainSettings, double sampleRate, CoefficientCache* cache = nullptr);
+
+// Samples until the slowest pole of any active section has decayed by
+// decayInDecibels, at the coefficients' own rate. Infinite if a pole sits
+// on or outside the unit circle.
+double getTailLengthSamples(const EQCoefficients& coefficients, double decayInDecibels = 120.0) noexcept;
+
+//==============================================================================
+// Allocation-free closed-form designs, using the same maths as
+// IIR::Coefficients' peak, shelf and notch factories and FilterDesign's
+// Butterworth cascades, so they are safe to call from the audio thread.
+BiquadCoefficients makeBandBiquad(BandType type, double sampleRate, float frequency, float quality, float gainFactor) noexcept;
+BiquadCoefficients makePeakBiquad(double sampleRate, float frequency, float quality, float gainFactor) noexcept;
+
+// Everything in a peak design that doesn't depend on its gain, so a gain-only
+// change (e.g. from a dynamic band) costs an exp, a divide and a few multiplies.
+struct PeakShape {
+    float alpha{ 0.0f }, c2{ -2.0f };
+};
+
+PeakShape makePeakShape(double sampleRate, float frequency, float quality) noexcept;
+BiquadCoefficients makePeakBiquad(const PeakShape& shape, float gainInDecibels) noexcept;
+
+void makeLowCutBand(BandCoefficients& band, double sampleRate, float frequency, Slope slope) noexcept;
+void makeHighCutBand(BandCoefficients& band, double sampleRate, float frequency, Slope slope) noexcept;
+
+// Redesigns the bands selected by bandMask (bit n == ChainPositions n) in
+// place and refreshes the active band list.
+// The cache is optional; lookups and inserts on it are realtime safe.
+void updateEQCoefficients(EQCoefficients& coefficients, const ChainSettings& chainSettings, double sampleRate, int bandMask,
+    CoefficientCache* cache = nullptr) noexcept;
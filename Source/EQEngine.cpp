@@ -0,0 +1,325 @@
+/*
+  ==============================================================================
+
+    EQEngine.cpp
+
+  ==============================================================================
+*/
+
+#include "EQEngine.h"
+
+// Stage 0 keeps 0.23 of its output rate (20.3 kHz at 44.1 kHz) and rejects
+// images by 96 dB; later stages only need to keep that same audio band, so
+// their transition widens and they get much cheaper.
+static const std::array<HalfBandCoefficients, EQEngine::maxOversamplingOrder>& getHalfBandDesigns() {
+    static const std::array<HalfBandCoefficients, EQEngine::maxOversamplingOrder> designs = [] {
+        std::array<HalfBandCoefficients, EQEngine::maxOversamplingOrder> result;
+
+        for (int stage = 0; stage < EQEngine::maxOversamplingOrder; ++stage)
+            result[static_cast<size_t>(stage)] = designHalfBand(96.0, 0.25 - 0.23 / (1 << stage));
+
+        return result;
+    }();
+
+    return designs;
+}
+
+int EQEngine::getOversamplingLatency(int order) {
+    double latency = 0.0;
+
+    // One pass up and one down per stage, converted from the stage's rate to the base rate.
+    for (int stage = 0; stage < juce::jmin(order, maxOversamplingOrder); ++stage) {
+        const double stageFactor = static_cast<double>(2 << stage);
+        latency += 2.0 * getHalfBandPhaseDelay(getHalfBandDesigns()[static_cast<size_t>(stage)], 0.01 / stageFactor) / stageFactor;
+    }
+
+    return juce::roundToInt(latency);
+}
+
+void EQEngine::prepare(double sampleRate, int maxBlockSize, int channels) {
+    juce::ignoreUnused(sampleRate);
+
+    numChannels = juce::jmax(0, channels);
+    maximumBlockSize = juce::jmax(0, maxBlockSize);
+    kernels = &DSPKernels::select();
+
+    groups.clear();
+    for (int firstChannel = 0; firstChannel < numChannels; firstChannel += laneWidth) {
+        ChannelGroup* group = groups.add(new ChannelGroup());
+        group->firstChannel = firstChannel;
+        group->numChannels = juce::jmin(laneWidth, numChannels - firstChannel);
+        group->cascade.reset();
+
+        for (int stage = 0; stage < maxOversamplingOrder; ++stage) {
+            group->upsamplers[static_cast<size_t>(stage)].setCoefficients(getHalfBandDesigns()[static_cast<size_t>(stage)]);
+            group->downsamplers[static_cast<size_t>(stage)].setCoefficients(getHalfBandDesigns()[static_cast<size_t>(stage)]);
+        }
+    }
+
+    scratch.resize(static_cast<size_t>(workerPool != nullptr ? workerPool->getNumSlots() : 1));
+
+    for (Scratch& buffers : scratch) {
+        buffers.interleaved.assign(static_cast<size_t>(maximumBlockSize), SIMDSample::expand(0.0f));
+
+        for (std::vector<SIMDSample>& buffer : buffers.oversampled)
+            buffer.assign(static_cast<size_t>(maximumBlockSize << maxOversamplingOrder), SIMDSample::expand(0.0f));
+    }
+
+    // New groups start with the sections from the last setCoefficients call.
+    updateCascades();
+}
+
+void EQEngine::reset() {
+    for (ChannelGroup* group : groups) {
+        group->cascade.reset();
+
+        for (int stage = 0; stage < maxOversamplingOrder; ++stage) {
+            group->upsamplers[static_cast<size_t>(stage)].reset();
+            group->downsamplers[static_cast<size_t>(stage)].reset();
+        }
+    }
+}
+
+void EQEngine::setOversamplingOrder(int order) noexcept {
+    order = juce::jlimit(0, maxOversamplingOrder, order);
+    if (order == oversamplingOrder)
+        return;
+
+    oversamplingOrder = order;
+    reset();
+}
+
+static BiquadCoefficients withGain(BiquadCoefficients section, float gainFactor) noexcept {
+    section.b0 *= gainFactor;
+    section.b1 *= gainFactor;
+    section.b2 *= gainFactor;
+    return section;
+}
+
+void EQEngine::setCoefficients(const EQCoefficients& coefficients) {
+    // Flatten the stages of the active bands, in chain order, into one cascade.
+    // The key band * maxSections + stage lets the state follow a stage when a
+    // slope change or a band switching on or off moves sections around it.
+    numSections = 0;
+
+    bandOffsets.fill(-1);
+    bandSections.fill(0);
+
+    for (int index = 0; index < coefficients.numActiveBands; ++index) {
+        const int band = coefficients.activeBands[index];
+        const BandCoefficients& bandCoefficients = coefficients.bands[band];
+        bandOffsets[band] = numSections;
+        bandSections[band] = bandCoefficients.numSections;
+
+        for (int stage = 0; stage < bandCoefficients.numSections; ++stage) {
+            sections[numSections] = bandCoefficients.sections[stage];
+            sectionKeys[numSections] = band * BandCoefficients::maxSections + stage;
+            sectionPlacements[numSections] = coefficients.settings.placements[static_cast<size_t>(band)];
+            ++numSections;
+        }
+    }
+
+    outputGain = juce::Decibels::decibelsToGain(coefficients.settings.outputGain);
+    stereoMode = coefficients.settings.stereoMode;
+    updateCascades();
+}
+
+void EQEngine::setOutputGain(float gainFactor) noexcept {
+    if (gainFactor == outputGain)
+        return;
+
+    outputGain = gainFactor;
+
+    if (numSections == 0) {
+        updateCascades();
+        return;
+    }
+
+    updateSection(numSections - 1);
+}
+
+// A section as channel 0 or 1 sees it, with the output gain folded in. While
+// the pair is split, a band placed on the other channel passes this one through.
+BiquadCoefficients EQEngine::getChannelSection(int index, int channel) const noexcept {
+    const BandPlacement placement = sectionPlacements[index];
+    const bool skipped = splitChannels && placement != BothChannels && (placement == SecondChannel) != (channel == 1);
+    const BiquadCoefficients section = skipped ? BiquadCoefficients() : sections[index];
+
+    return index == numSections - 1 ? withGain(section, outputGain) : section;
+}
+
+void EQEngine::updateCascades() noexcept {
+    // Placements only mean something for a stereo pair. With the same bands
+    // on both channels, filtering mid and side is filtering left and right,
+    // so the encode is only done when they differ.
+    splitChannels = numChannels == 2
+        && std::any_of(sectionPlacements.begin(), sectionPlacements.begin() + numSections, [](BandPlacement placement) { return placement != BothChannels; });
+    encodeMidSide = splitChannels && stereoMode == MidSide;
+
+    std::array<BiquadCoefficients, Cascade::maxSections> scaled;
+    std::array<int, Cascade::maxSections> keys = sectionKeys;
+    int count = numSections;
+
+    for (int index = 0; index < numSections; ++index)
+        scaled[index] = getChannelSection(index, 0);
+
+    if (count == 0 && outputGain != 1.0f) {
+        scaled[0] = withGain(BiquadCoefficients(), outputGain);
+        keys[0] = outputGainKey;
+        count = 1;
+    }
+
+    for (ChannelGroup* group : groups)
+        group->cascade.setSections(scaled.data(), keys.data(), count);
+
+    if (splitChannels)
+        for (int index = 0; index < numSections; ++index)
+            groups.getUnchecked(0)->cascade.setLaneSection(index, 1, getChannelSection(index, 1));
+}
+
+void EQEngine::updateSection(int index) noexcept {
+    const BiquadCoefficients section = getChannelSection(index, 0);
+    for (ChannelGroup* group : groups)
+        group->cascade.setSection(index, section);
+
+    if (splitChannels)
+        groups.getUnchecked(0)->cascade.setLaneSection(index, 1, getChannelSection(index, 1));
+}
+
+void EQEngine::setBandSection(int band, int stage, const BiquadCoefficients& section) noexcept {
+    jassert(band >= 0 && band < EQCoefficients::numBands);
+
+    if (stage < 0 || stage >= bandSections[band])
+        return;
+
+    const int index = bandOffsets[band] + stage;
+    sections[index] = section;
+    updateSection(index);
+}
+
+void EQEngine::process(const juce::dsp::AudioBlock<float>& block) {
+    jassert(static_cast<int>(block.getNumSamples()) <= maximumBlockSize);
+
+    if (isPassThrough())
+        return;
+
+    // Only the output gain is left: scale the channels where they are rather
+    // than run a one-section cascade over interleaved copies of them. That
+    // section never holds any state, so switching between the two is seamless.
+    if (numSections == 0 && oversamplingOrder == 0) {
+        const int channelsToScale = juce::jmin(numChannels, static_cast<int>(block.getNumChannels()));
+
+        for (int channel = 0; channel < channelsToScale; ++channel)
+            kernels->gain(block.getChannelPointer(static_cast<size_t>(channel)), static_cast<int>(block.getNumSamples()), outputGain);
+
+        return;
+    }
+
+    const int numGroupsToRun = juce::jmin(groups.size(), (static_cast<int>(block.getNumChannels()) + laneWidth - 1) / laneWidth);
+
+    if (shouldRunInParallel(numGroupsToRun, static_cast<int>(block.getNumSamples()))) {
+        auto task = [this, &block](int index, int slot) {
+            processGroup(*groups.getUnchecked(index), block, scratch[static_cast<size_t>(slot)]);
+        };
+
+        workerPool->run(numGroupsToRun, task);
+        return;
+    }
+
+    for (int index = 0; index < numGroupsToRun; ++index)
+        processGroup(*groups.getUnchecked(index), block, scratch.front());
+}
+
+// Only with groups to share out, enough work in the block to pay for the
+// handoff, and scratch that prepare sized for this pool. The half-band
+// stages are counted as a section each way.
+bool EQEngine::shouldRunInParallel(int numGroupsToRun, int numSamples) const noexcept {
+    if (workerPool == nullptr || numGroupsToRun < 2 || static_cast<int>(scratch.size()) != workerPool->getNumSlots())
+        return false;
+
+    const juce::int64 sectionsPerSample = juce::jmax(1, numSections) + 2 * oversamplingOrder;
+    return static_cast<juce::int64>(numGroupsToRun) * (numSamples << oversamplingOrder) * sectionsPerSample >= minParallelWork;
+}
+
+void EQEngine::processGroup(ChannelGroup& group, const juce::dsp::AudioBlock<float>& block, Scratch& buffers) {
+    const int numSamples = static_cast<int>(block.getNumSamples());
+    const int channelsInGroup = juce::jmin(group.numChannels, static_cast<int>(block.getNumChannels()) - group.firstChannel);
+    std::vector<SIMDSample>& interleaved = buffers.interleaved;
+    float* lanes = reinterpret_cast<float*>(interleaved.data());
+
+    // Mid and side go into the first two lanes in the same pass that interleaves them.
+    const bool midSide = encodeMidSide && group.firstChannel == 0 && channelsInGroup >= 2;
+    const int firstPlainLane = midSide ? 2 : 0;
+
+    // Unused lanes of a partial group stay at zero so they never produce denormals or NaNs.
+    if (channelsInGroup < laneWidth)
+        std::fill(interleaved.begin(), interleaved.begin() + numSamples, SIMDSample::expand(0.0f));
+
+    if (midSide) {
+        const float* left = block.getChannelPointer(0);
+        const float* right = block.getChannelPointer(1);
+
+        for (int sample = 0; sample < numSamples; ++sample) {
+            lanes[sample * laneWidth] = 0.5f * (left[sample] + right[sample]);
+            lanes[sample * laneWidth + 1] = 0.5f * (left[sample] - right[sample]);
+        }
+    }
+
+    for (int lane = firstPlainLane; lane < channelsInGroup; ++lane) {
+        const float* input = block.getChannelPointer(static_cast<size_t>(group.firstChannel + lane));
+        for (int sample = 0; sample < numSamples; ++sample)
+            lanes[sample * laneWidth + lane] = input[sample];
+    }
+
+    if (oversamplingOrder > 0)
+        processOversampled(group, buffers, numSamples);
+    else
+        group.cascade.process(interleaved.data(), numSamples, *kernels);
+
+    if (midSide) {
+        float* left = block.getChannelPointer(0);
+        float* right = block.getChannelPointer(1);
+
+        for (int sample = 0; sample < numSamples; ++sample) {
+            const float mid = lanes[sample * laneWidth];
+            const float side = lanes[sample * laneWidth + 1];
+            left[sample] = mid + side;
+            right[sample] = mid - side;
+        }
+    }
+
+    for (int lane = firstPlainLane; lane < channelsInGroup; ++lane) {
+        float* output = block.getChannelPointer(static_cast<size_t>(group.firstChannel + lane));
+        for (int sample = 0; sample < numSamples; ++sample)
+            output[sample] = lanes[sample * laneWidth + lane];
+    }
+}
+
+void EQEngine::processOversampled(ChannelGroup& group, Scratch& buffers, int numSamples) {
+    std::vector<SIMDSample>& interleaved = buffers.interleaved;
+    std::array<std::vector<SIMDSample>, 2>& oversampled = buffers.oversampled;
+
+    // Stage s writes its 2^(s + 1) rate output to oversampled[s % 2]; the way
+    // back down mirrors it, ending in the interleaved buffer again.
+    const SIMDSample* source = interleaved.data();
+    int length = numSamples;
+
+    for (int stage = 0; stage < oversamplingOrder; ++stage) {
+        SIMDSample* destination = oversampled[static_cast<size_t>(stage % 2)].data();
+        group.upsamplers[static_cast<size_t>(stage)].upsample(source, destination, length);
+
+        source = destination;
+        length *= 2;
+    }
+
+    SIMDSample* samples = oversampled[static_cast<size_t>((oversamplingOrder - 1) % 2)].data();
+    group.cascade.process(samples, length, *kernels);
+
+    for (int stage = oversamplingOrder - 1; stage >= 0; --stage) {
+        SIMDSample* destination = stage == 0 ? interleaved.data() : oversampled[static_cast<size_t>((stage - 1) % 2)].data();
+        length /= 2;
+
+        group.downsamplers[static_cast<size_t>(stage)].downsample(samples, destination, length);
+        samples = destination;
+    }
+}
@@ -0,0 +1,157 @@
+/*
+  ==============================================================================
+
+    EQEngine.h
+
+    Runs the EQ cascade over any number of channels. Channels are split into
+    groups of SIMDSample::size() and each group is filtered in one vectorised
+    pass, so the cost grows with channels / lane width. The cascade can run
+    2x/4x/8x oversampled through polyphase half-band stages, which work on
+    the same interleaved groups.
+
+    A stereo engine can filter its two channels differently: bands placed
+    on one channel pass the other lane straight through, and in mid/side
+    mode the pair is encoded as it is interleaved and decoded as it is read
+    back. Both channels still run in the one vectorised pass.
+
+    The cascade and the gain run through the DSPKernels variant picked when
+    the engine is prepared. Given a RealtimeWorkerPool, the groups of a big
+    enough block are filtered in parallel, each thread with scratch buffers
+    of its own.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ChainSettings.h"
+#include "EQCoefficients.h"
+#include "BiquadCascade.h"
+#include "HalfBandOversampler.h"
+#include "RealtimeWorkerPool.h"
+
+//==============================================================================
+class EQEngine {
+public:
+    static constexpr int laneWidth = static_cast<int>(SIMDSample::size());
+    static constexpr int maxOversamplingOrder = 3;
+
+    // Mid/side needs both channels of the pair in one group.
+    static_assert(laneWidth >= 2, "A stereo pair has to fit in one SIMD group");
+
+    // Work per block, in group-samples times sections (at roughly a
+    // nanosecond each), below which waking the workers and waiting at the
+    // barrier costs more than it saves.
+    static constexpr int minParallelWork = 16384;
+
+    EQEngine() = default;
+
+    // Channel groups may then be spread across the pool's threads. Call
+    // before prepare, which sizes the scratch buffers for it; nullptr keeps
+    // everything on the calling thread. The pool must outlive its use here.
+    void setWorkerPool(RealtimeWorkerPool* pool) noexcept { workerPool = pool; }
+
+    // Allocates the per-channel filter state, with room for the highest
+    // oversampling factor, and picks the kernels. Not realtime safe.
+    void prepare(double sampleRate, int maximumBlockSize, int numChannels);
+    void reset();
+
+    // 0 = off, 1..3 = 2x..8x. Coefficients must be designed for the
+    // oversampled rate. Clears the resampler state; realtime safe.
+    void setOversamplingOrder(int order) noexcept;
+    int getOversamplingOrder() const noexcept { return oversamplingOrder; }
+
+    // Low-frequency group delay of the half-band stages, in samples at the base rate.
+    static int getOversamplingLatency(int order);
+
+    // Copies the active sections into every group's cascade, with the
+    // settings' output gain folded into the last one. With two channels,
+    // the settings' band placements and stereo mode apply too. Realtime safe.
+    void setCoefficients(const EQCoefficients& coefficients);
+
+    // Rescales the last section only, so a ramping output gain costs no
+    // extra pass. With no sections at all the gain gets one of its own.
+    void setOutputGain(float gainFactor) noexcept;
+
+    // Replaces one stage of a band set by the last setCoefficients call.
+    // Cheaper than setCoefficients when only a gain is moving.
+    void setBandSection(int band, int stage, const BiquadCoefficients& section) noexcept;
+
+    // Filters the first getNumChannels() channels of the block in place.
+    // Returns straight away when isPassThrough().
+    void process(const juce::dsp::AudioBlock<float>& block);
+
+    // Every band is elided, the gain is unity and nothing is resampled.
+    bool isPassThrough() const noexcept { return numSections == 0 && outputGain == 1.0f && oversamplingOrder == 0; }
+
+    int getNumChannels() const noexcept { return numChannels; }
+    const DSPKernels& getKernels() const noexcept { return *kernels; }
+    int getNumGroups() const noexcept { return groups.size(); }
+
+    // A stereo engine whose two channels get different bands; only then
+    // does mid/side mode encode anything.
+    bool isSplitStereo() const noexcept { return splitChannels; }
+
+private:
+    using Cascade = BiquadCascade<SIMDSample>;
+    using HalfBand = HalfBandStage<SIMDSample>;
+
+    struct ChannelGroup {
+        Cascade cascade;
+        std::array<HalfBand, maxOversamplingOrder> upsamplers, downsamplers;
+        int firstChannel{ 0 };
+        int numChannels{ 0 };
+    };
+
+    // Stands in for the output gain when every band is elided.
+    static constexpr int outputGainKey = EQCoefficients::numBands * BandCoefficients::maxSections;
+
+    // The interleaving buffer and the two buffers the half-band stages
+    // ping-pong between. Groups on one thread run one after another, so
+    // each thread needs only one set.
+    struct Scratch {
+        std::vector<SIMDSample> interleaved;
+        std::array<std::vector<SIMDSample>, 2> oversampled;
+    };
+
+    void updateCascades() noexcept;
+    void updateSection(int index) noexcept;
+    BiquadCoefficients getChannelSection(int index, int channel) const noexcept;
+    bool shouldRunInParallel(int numGroupsToRun, int numSamples) const noexcept;
+    void processGroup(ChannelGroup& group, const juce::dsp::AudioBlock<float>& block, Scratch& buffers);
+    void processOversampled(ChannelGroup& group, Scratch& buffers, int numSamples);
+
+    juce::OwnedArray<ChannelGroup> groups;
+
+    // One per slot of the worker pool, or just one without it.
+    std::vector<Scratch> scratch;
+    RealtimeWorkerPool* workerPool{ nullptr };
+
+    // The flattened sections as designed, before the output gain is applied.
+    std::array<BiquadCoefficients, Cascade::maxSections> sections;
+    std::array<int, Cascade::maxSections> sectionKeys{};
+    int numSections{ 0 };
+    float outputGain{ 1.0f };
+
+    // The placement of the band each section belongs to. Once any of them
+    // isn't on both channels, channel 1 gets coefficients of its own, with
+    // pass-through sections wherever a band is only on channel 0, and the
+    // other way round, so both lanes keep one layout and one state array.
+    std::array<BandPlacement, Cascade::maxSections> sectionPlacements{};
+    StereoMode stereoMode{ LeftRight };
+    bool splitChannels{ false };
+    bool encodeMidSide{ false };
+
+    // Index of each band's first section in the cascade, -1 while it has none.
+    std::array<int, EQCoefficients::numBands> bandOffsets{};
+    std::array<int, EQCoefficients::numBands> bandSections{};
+
+    const DSPKernels* kernels{ DSPKernels::get(DSPKernels::Scalar) };
+
+    int oversamplingOrder{ 0 };
+    int numChannels{ 0 };
+    int maximumBlockSize{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EQEngine)
+};
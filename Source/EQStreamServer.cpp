@@ -0,0 +1,265 @@
+/*
+  ==============================================================================
+
+    EQStreamServer.cpp
+
+  ==============================================================================
+*/
+
+#include "EQStreamServer.h"
+#include "DynamicEQ.h"
+#include "EQCoefficients.h"
+#include "EQEngine.h"
+
+//==============================================================================
+struct EQStreamServer::Stream {
+    double sampleRate{ 0.0 };
+    int numChannels{ 0 };
+    int maximumBlockSize{ 0 };
+
+    // Only touched by the worker running the stream's block; one block per
+    // stream is queued at a time, so there is never more than one.
+    EQEngine engine;
+    DynamicEQ dynamics;
+    ChainSettings settings;
+
+    juce::SpinLock pendingLock;
+    EQCoefficients pendingCoefficients;
+    bool hasPendingCoefficients{ false };
+
+    std::atomic<bool> isQueued{ false };
+
+    // Read when batching, so it is atomic; the estimate starts at a typical
+    // stereo cost and follows the measurements from there.
+    std::atomic<double> msPerSample{ 20.0e-6 };
+
+    juce::SpinLock statsLock;
+    juce::int64 blocks{ 0 }, deadlineMisses{ 0 }, samples{ 0 };
+    double totalLatencyMs{ 0.0 }, maxLatencyMs{ 0.0 }, cpuMs{ 0.0 };
+};
+
+//==============================================================================
+EQStreamServer::EQStreamServer(int numWorkers)
+    : pool(numWorkers, "EQ Stream Worker") {
+}
+
+EQStreamServer::~EQStreamServer() {
+    pool.waitForAll();
+}
+
+EQStreamServer::StreamID EQStreamServer::addStream(double sampleRate, int numChannels, int maximumBlockSize, const ChainSettings& chainSettings) {
+    auto stream = std::make_unique<Stream>();
+    stream->sampleRate = sampleRate;
+    stream->numChannels = juce::jmax(1, numChannels);
+    stream->maximumBlockSize = juce::jmax(1, maximumBlockSize);
+    stream->settings = chainSettings;
+
+    stream->engine.prepare(sampleRate, stream->maximumBlockSize, stream->numChannels);
+    stream->engine.setOversamplingOrder(chainSettings.oversamplingOrder);
+    stream->engine.setCoefficients(designEQCoefficients(chainSettings, getProcessingSampleRate(chainSettings, sampleRate), coefficientCache));
+
+    // There is no sidechain here; dynamic bands key from the stream itself.
+    stream->dynamics.prepare(sampleRate, stream->maximumBlockSize, stream->numChannels);
+    stream->dynamics.setSettings(chainSettings, getProcessingSampleRate(chainSettings, sampleRate));
+
+    const juce::ScopedLock sl(streamLock);
+    const StreamID id = nextStreamID++;
+    streams.emplace(id, std::move(stream));
+
+    // One block per stream per cycle, so this is as big as the queues get.
+    const juce::ScopedLock ql(queueLock);
+    queued.reserve(streams.size());
+    running.reserve(streams.size());
+    batches.reserve(streams.size());
+    return id;
+}
+
+void EQStreamServer::removeStream(StreamID stream) {
+    const juce::ScopedLock sl(streamLock);
+    const auto found = streams.find(stream);
+    if (found == streams.end())
+        return;
+
+    {
+        const juce::ScopedLock ql(queueLock);
+        queued.erase(std::remove_if(queued.begin(), queued.end(),
+            [&](const PendingBlock& block) { return block.stream == found->second.get(); }), queued.end());
+    }
+
+    streams.erase(found);
+}
+
+EQStreamServer::Stream* EQStreamServer::findStream(StreamID stream) const {
+    const juce::ScopedLock sl(streamLock);
+    const auto found = streams.find(stream);
+    return found != streams.end() ? found->second.get() : nullptr;
+}
+
+void EQStreamServer::setSettings(StreamID id, const ChainSettings& chainSettings) {
+    Stream* stream = findStream(id);
+    if (stream == nullptr)
+        return;
+
+    const EQCoefficients coefficients = designEQCoefficients(chainSettings, getProcessingSampleRate(chainSettings, stream->sampleRate), coefficientCache);
+
+    const juce::SpinLock::ScopedLockType lock(stream->pendingLock);
+    stream->pendingCoefficients = coefficients;
+    stream->hasPendingCoefficients = true;
+}
+
+bool EQStreamServer::submit(StreamID id, float* const* channels, int numSamples, double deadlineMs) {
+    Stream* stream = findStream(id);
+
+    if (stream == nullptr || numSamples <= 0 || numSamples > stream->maximumBlockSize || stream->isQueued.exchange(true))
+        return false;
+
+    const juce::ScopedLock ql(queueLock);
+    queued.push_back({ stream, channels, numSamples, juce::Time::getMillisecondCounterHiRes(), deadlineMs });
+    return true;
+}
+
+//==============================================================================
+void EQStreamServer::buildBatches(double nowMs) {
+    batches.clear();
+
+    int first = 0;
+    double batchMs = 0.0;
+
+    for (int index = 0; index < static_cast<int>(running.size()); ++index) {
+        const PendingBlock& block = running[static_cast<size_t>(index)];
+        const double blockMs = block.stream->msPerSample.load(std::memory_order_relaxed) * block.numSamples;
+
+        // A batch closes once it holds enough work to be worth a job of its
+        // own, or sooner if its most urgent block can't afford to wait.
+        const double slackMs = running[static_cast<size_t>(first)].deadlineMs - nowMs;
+
+        if (index > first && batchMs + blockMs > juce::jmin(targetBatchMs, slackMs * 0.5)) {
+            batches.push_back({ first, index });
+            first = index;
+            batchMs = 0.0;
+        }
+
+        batchMs += blockMs;
+    }
+
+    if (!running.empty())
+        batches.push_back({ first, static_cast<int>(running.size()) });
+}
+
+void EQStreamServer::processPending() {
+    {
+        const juce::ScopedLock ql(queueLock);
+        running.swap(queued);
+        queued.clear();
+    }
+
+    if (running.empty())
+        return;
+
+    std::sort(running.begin(), running.end(),
+        [](const PendingBlock& a, const PendingBlock& b) { return a.deadlineMs < b.deadlineMs; });
+
+    buildBatches(juce::Time::getMillisecondCounterHiRes());
+
+    // Workers run their own deque newest-first, so the most urgent batches go in last.
+    for (auto batch = batches.rbegin(); batch != batches.rend(); ++batch) {
+        const juce::Range<int> range = *batch;
+
+        pool.submit([this, range] {
+            for (int index = range.getStart(); index < range.getEnd(); ++index)
+                processBlock(running[static_cast<size_t>(index)]);
+        });
+    }
+
+    pool.waitForAll();
+    running.clear();
+}
+
+void EQStreamServer::processBlock(const PendingBlock& block) {
+    // Pool threads start with denormals on, and neither the cascade nor the
+    // detectors flush their SIMD state, so a decaying stream would crawl.
+    const juce::ScopedNoDenormals noDenormals;
+    Stream& stream = *block.stream;
+    const double startMs = juce::Time::getMillisecondCounterHiRes();
+
+    // A design that is still being written waits for the next block.
+    {
+        const juce::SpinLock::ScopedTryLockType lock(stream.pendingLock);
+
+        if (lock.isLocked() && stream.hasPendingCoefficients) {
+            stream.hasPendingCoefficients = false;
+            stream.settings = stream.pendingCoefficients.settings;
+            stream.engine.setOversamplingOrder(stream.settings.oversamplingOrder);
+            stream.engine.setCoefficients(stream.pendingCoefficients);
+            stream.dynamics.setSettings(stream.settings, stream.pendingCoefficients.sampleRate);
+        }
+    }
+
+    const juce::dsp::AudioBlock<float> audio(block.channels, static_cast<size_t>(stream.numChannels), static_cast<size_t>(block.numSamples));
+
+    if (stream.dynamics.isActive())
+        stream.dynamics.process(stream.engine, stream.settings, audio);
+    else
+        stream.engine.process(audio);
+
+    const double endMs = juce::Time::getMillisecondCounterHiRes();
+    const double elapsedMs = endMs - startMs;
+    const double latencyMs = endMs - block.submittedMs;
+
+    const double estimate = stream.msPerSample.load(std::memory_order_relaxed);
+    stream.msPerSample.store(estimate + 0.1 * (elapsedMs / block.numSamples - estimate), std::memory_order_relaxed);
+
+    {
+        const juce::SpinLock::ScopedLockType lock(stream.statsLock);
+        ++stream.blocks;
+        stream.samples += block.numSamples;
+        stream.cpuMs += elapsedMs;
+        stream.totalLatencyMs += latencyMs;
+        stream.maxLatencyMs = juce::jmax(stream.maxLatencyMs, latencyMs);
+
+        if (endMs > block.deadlineMs)
+            ++stream.deadlineMisses;
+    }
+
+    stream.isQueued.store(false);
+}
+
+//==============================================================================
+EQStreamServer::StreamStats EQStreamServer::getStats(StreamID id) const {
+    StreamStats result;
+
+    const juce::ScopedLock sl(streamLock);
+    const auto found = streams.find(id);
+    if (found == streams.end())
+        return result;
+
+    Stream& stream = *found->second;
+    const juce::SpinLock::ScopedLockType lock(stream.statsLock);
+
+    result.blocks = stream.blocks;
+    result.deadlineMisses = stream.deadlineMisses;
+    result.meanLatencyMs = stream.blocks > 0 ? stream.totalLatencyMs / static_cast<double>(stream.blocks) : 0.0;
+    result.maxLatencyMs = stream.maxLatencyMs;
+    result.cpuSeconds = stream.cpuMs / 1000.0;
+    result.realtimeLoad = stream.samples > 0 ? result.cpuSeconds / (static_cast<double>(stream.samples) / stream.sampleRate) : 0.0;
+    return result;
+}
+
+void EQStreamServer::resetStats() {
+    const juce::ScopedLock sl(streamLock);
+
+    for (auto& [id, stream] : streams) {
+        const juce::SpinLock::ScopedLockType lock(stream->statsLock);
+        stream->blocks = 0;
+        stream->deadlineMisses = 0;
+        stream->samples = 0;
+        stream->totalLatencyMs = 0.0;
+        stream->maxLatencyMs = 0.0;
+        stream->cpuMs = 0.0;
+    }
+}
+
+int EQStreamServer::getNumStreams() const {
+    const juce::ScopedLock sl(streamLock);
+    return static_cast<int>(streams.size());
+}
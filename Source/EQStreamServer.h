@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+
+    EQStreamServer.h
+
+    Headless host for many independent EQ streams, without the plugin's
+    AudioProcessor or editor. Each stream has its own settings and filter
+    state. Queued blocks are sorted by deadline, grouped into batches whose
+    size follows the measured cost of each stream and the slack of the most
+    urgent block, and run on a shared work-stealing pool. Latency and
+    processing time are tracked per stream.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ChainSettings.h"
+#include "CoefficientCache.h"
+#include "WorkStealingPool.h"
+
+//==============================================================================
+class EQStreamServer {
+public:
+    using StreamID = int;
+
+    struct StreamStats {
+        juce::int64 blocks{ 0 };
+        juce::int64 deadlineMisses{ 0 };
+        double meanLatencyMs{ 0.0 };    // from submit() to the block being done
+        double maxLatencyMs{ 0.0 };
+        double cpuSeconds{ 0.0 };       // spent filtering this stream on a worker
+        double realtimeLoad{ 0.0 };     // cpuSeconds per second of audio processed
+    };
+
+    // Work a batch is filled up to, unless its most urgent block has less
+    // than twice that much slack left.
+    static constexpr double targetBatchMs = 0.25;
+
+    explicit EQStreamServer(int numWorkers = juce::SystemStats::getNumCpus());
+    ~EQStreamServer();
+
+    // Control thread; these allocate and must not overlap processPending().
+    StreamID addStream(double sampleRate, int numChannels, int maximumBlockSize, const ChainSettings& chainSettings);
+    void removeStream(StreamID stream);
+
+    // Any thread. The coefficients are designed on the calling thread and
+    // the stream switches to them at the start of its next block.
+    void setSettings(StreamID stream, const ChainSettings& chainSettings);
+
+    // Any thread. Queues one block to be filtered in place by the next
+    // processPending(); a stream can only have one block queued at a time.
+    // deadlineMs is on juce::Time::getMillisecondCounterHiRes()'s clock.
+    bool submit(StreamID stream, float* const* channels, int numSamples, double deadlineMs);
+
+    // Runs every queued block, most urgent first, and returns when all are done.
+    void processPending();
+
+    StreamStats getStats(StreamID stream) const;
+    void resetStats();
+
+    int getNumStreams() const;
+    int getNumWorkers() const noexcept { return pool.getNumWorkers(); }
+
+private:
+    struct Stream;
+
+    struct PendingBlock {
+        Stream* stream;
+        float* const* channels;
+        int numSamples;
+        double submittedMs, deadlineMs;
+    };
+
+    Stream* findStream(StreamID stream) const;
+    void buildBatches(double nowMs);
+    static void processBlock(const PendingBlock& block);
+
+    WorkStealingPool pool;
+    juce::SharedResourcePointer<CoefficientCache> coefficientCache;
+
+    mutable juce::CriticalSection streamLock;
+    std::map<StreamID, std::unique_ptr<Stream>> streams;
+    StreamID nextStreamID{ 1 };
+
+    juce::CriticalSection queueLock;
+    std::vector<PendingBlock> queued, running;
+    std::vector<juce::Range<int>> batches;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EQStreamServer)
+};
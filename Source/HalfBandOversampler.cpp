@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+    HalfBandOversampler.cpp
+
+    Coefficient design follows Laurent de Soras' HIIR library: the allpass
+    coefficients of an elliptic half-band filter come from a closed-form
+    expansion in the elliptic nome q.
+
+  ==============================================================================
+*/
+
+#include "HalfBandOversampler.h"
+
+static void computeTransitionParameters(double transition, double& k, double& q) {
+    k = std::tan((1.0 - transition * 2.0) * juce::MathConstants<double>::pi / 4.0);
+    k *= k;
+
+    const double kksqrt = std::pow(1.0 - k * k, 0.25);
+    const double e = 0.5 * (1.0 - kksqrt) / (1.0 + kksqrt);
+    const double e2 = e * e;
+    const double e4 = e2 * e2;
+
+    q = e * (1.0 + e4 * (2.0 + e4 * (15.0 + 150.0 * e4)));
+}
+
+static int computeOrder(double attenuationDb, double q) {
+    const double attenuationPower = std::pow(10.0, -attenuationDb / 10.0);
+    const double a = attenuationPower / (1.0 - attenuationPower);
+
+    int order = static_cast<int>(std::ceil(std::log(a * a / 16.0) / std::log(q)));
+    if ((order & 1) == 0)
+        ++order;
+
+    return juce::jmax(3, order);
+}
+
+static double computeNumeratorSum(double q, int order, int c) {
+    double sum = 0.0, term;
+    int sign = 1;
+
+    for (int i = 0;; ++i, sign = -sign) {
+        term = std::pow(q, i * (i + 1)) * std::sin((i * 2 + 1) * c * juce::MathConstants<double>::pi / order) * sign;
+        sum += term;
+
+        if (std::abs(term) <= 1.0e-100)
+            return sum;
+    }
+}
+
+static double computeDenominatorSum(double q, int order, int c) {
+    double sum = 0.0, term;
+    int sign = -1;
+
+    for (int i = 1;; ++i, sign = -sign) {
+        term = std::pow(q, i * i) * std::cos(i * 2 * c * juce::MathConstants<double>::pi / order) * sign;
+        sum += term;
+
+        if (std::abs(term) <= 1.0e-100)
+            return sum;
+    }
+}
+
+static double computeCoefficient(int index, double k, double q, int order) {
+    const int c = index + 1;
+    const double numerator = computeNumeratorSum(q, order, c) * std::pow(q, 0.25);
+    const double denominator = computeDenominatorSum(q, order, c) + 0.5;
+    const double ww = numerator / denominator;
+    const double wwSquared = ww * ww;
+
+    const double x = std::sqrt((1.0 - wwSquared * k) * (1.0 - wwSquared / k)) / (1.0 + wwSquared);
+    return (1.0 - x) / (1.0 + x);
+}
+
+HalfBandCoefficients designHalfBand(double attenuationDb, double transition) {
+    jassert(transition > 0.0 && transition < 0.5);
+
+    double k, q;
+    computeTransitionParameters(transition, k, q);
+
+    const int order = computeOrder(attenuationDb, q);
+
+    HalfBandCoefficients coefficients;
+    coefficients.numCoefficients = juce::jmin((order - 1) / 2, HalfBandCoefficients::maxCoefficients);
+
+    // If the count was clamped this designs the highest order that fits,
+    // trading some stopband attenuation.
+    for (int index = 0; index < coefficients.numCoefficients; ++index)
+        coefficients.allpass[static_cast<size_t>(index)] = static_cast<float>(computeCoefficient(index, k, q, coefficients.numCoefficients * 2 + 1));
+
+    return coefficients;
+}
+
+double getHalfBandPhaseDelay(const HalfBandCoefficients& coefficients, double normalisedFrequency) {
+    using Complex = std::complex<double>;
+
+    const double omega = juce::MathConstants<double>::twoPi * normalisedFrequency;
+    const Complex zInverse2 = std::polar(1.0, -2.0 * omega);
+
+    Complex path0(1.0), path1(1.0);
+
+    // Every section is (a + z^-2) / (1 + a z^-2) at the higher rate.
+    for (int index = 0; index < coefficients.numCoefficients; ++index) {
+        const double a = coefficients.allpass[static_cast<size_t>(index)];
+        const Complex section = (a + zInverse2) / (1.0 + a * zInverse2);
+
+        if ((index & 1) == 0)
+            path0 *= section;
+        else
+            path1 *= section;
+    }
+
+    const Complex response = 0.5 * (path0 + std::polar(1.0, -omega) * path1);
+    return -std::arg(response) / omega;
+}
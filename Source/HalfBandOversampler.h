@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+    HalfBandOversampler.h
+
+    Polyphase IIR half-band stages for 2x/4x/8x oversampling. Each stage is
+    two chains of first-order allpass sections (Laurent de Soras' design),
+    running at the lower rate, and works on interleaved samples so one pass
+    resamples a whole group of channels.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+struct HalfBandCoefficients {
+    static constexpr int maxCoefficients = 16;
+
+    std::array<float, maxCoefficients> allpass{};
+    int numCoefficients{ 0 };
+};
+
+// Designs a half-band filter whose stopband rejects at least attenuationDb.
+// transition is the normalised transition width at the higher rate: the
+// passband ends at 0.25 - transition and the stopband starts at 0.25 + transition.
+HalfBandCoefficients designHalfBand(double attenuationDb, double transition);
+
+// Phase delay, in samples at the higher rate, of one up- or down-sampling pass at
+// normalisedFrequency (cycles per sample at the higher rate).
+double getHalfBandPhaseDelay(const HalfBandCoefficients& coefficients, double normalisedFrequency);
+
+//==============================================================================
+template <typename SampleType>
+class HalfBandStage {
+public:
+    void setCoefficients(const HalfBandCoefficients& coefficients) noexcept {
+        numCoefficients = juce::jmin(coefficients.numCoefficients, HalfBandCoefficients::maxCoefficients);
+
+        for (int index = 0; index < numCoefficients; ++index)
+            allpass[static_cast<size_t>(index)] = expand(coefficients.allpass[static_cast<size_t>(index)]);
+
+        reset();
+    }
+
+    void reset() noexcept {
+        x.fill(expand(0.0f));
+        y.fill(expand(0.0f));
+    }
+
+    // Writes 2 * numInputSamples samples.
+    void upsample(const SampleType* input, SampleType* output, int numInputSamples) noexcept {
+        for (int sample = 0; sample < numInputSamples; ++sample) {
+            SampleType even = input[sample];
+            SampleType odd = input[sample];
+
+            processPaths(even, odd);
+
+            output[sample * 2] = even;
+            output[sample * 2 + 1] = odd;
+        }
+    }
+
+    // Reads 2 * numOutputSamples samples.
+    void downsample(const SampleType* input, SampleType* output, int numOutputSamples) noexcept {
+        const SampleType half = expand(0.5f);
+
+        for (int sample = 0; sample < numOutputSamples; ++sample) {
+            SampleType path0 = input[sample * 2 + 1];
+            SampleType path1 = input[sample * 2];
+
+            processPaths(path0, path1);
+
+            output[sample] = (path0 + path1) * half;
+        }
+    }
+
+private:
+    static SampleType expand(float value) noexcept {
+        if constexpr (std::is_same_v<SampleType, float>)
+            return value;
+        else
+            return SampleType::expand(value);
+    }
+
+    // Even coefficients belong to the first path, odd ones to the second.
+    // Each section is y[n] = a * (x[n] - y[n - 1]) + x[n - 1] at the lower rate.
+    void processPaths(SampleType& path0, SampleType& path1) noexcept {
+        int index = 0;
+
+        for (; index + 1 < numCoefficients; index += 2) {
+            const SampleType out0 = (path0 - y[index]) * allpass[index] + x[index];
+            const SampleType out1 = (path1 - y[index + 1]) * allpass[index + 1] + x[index + 1];
+
+            x[index] = path0;
+            x[index + 1] = path1;
+            y[index] = out0;
+            y[index + 1] = out1;
+
+            path0 = out0;
+            path1 = out1;
+        }
+
+        if (index < numCoefficients) {
+            const SampleType out0 = (path0 - y[index]) * allpass[index] + x[index];
+
+            x[index] = path0;
+            y[index] = out0;
+            path0 = out0;
+        }
+    }
+
+    std::array<SampleType, HalfBandCoefficients::maxCoefficients> allpass, x, y;
+    int numCoefficients{ 0 };
+};
@@ -0,0 +1,144 @@
+/*
+  ==============================================================================
+
+    LinearPhaseEngine.cpp
+
+  ==============================================================================
+*/
+
+#include "LinearPhaseEngine.h"
+
+int LinearPhaseEngine::getKernelLength(double sampleRate) noexcept {
+    if (sampleRate <= 50000.0)
+        return 1 << 14;
+    if (sampleRate <= 100000.0)
+        return 1 << 15;
+    return 1 << 16;
+}
+
+void LinearPhaseEngine::prepare(double newSampleRate, int maxBlockSize, int numChannels) {
+    const juce::ScopedLock sl(designLock);
+
+    sampleRate = newSampleRate;
+    kernelLength = getKernelLength(sampleRate);
+
+    const int half = kernelLength / 2;
+
+    fft = std::make_unique<juce::dsp::FFT>(juce::findHighestSetBit(static_cast<juce::uint32>(kernelLength)));
+    spectrum.assign(static_cast<size_t>(kernelLength * 2), 0.0f);
+    kernel.setSize(1, kernelLength);
+
+    cosTable.resize(static_cast<size_t>(half + 1));
+    sinTable.resize(static_cast<size_t>(half + 1));
+    updateFrequencyTables(sampleRate);
+
+    // Periodic Blackman, symmetric about the kernel's centre sample.
+    window.resize(static_cast<size_t>(kernelLength));
+    for (int n = 0; n < kernelLength; ++n) {
+        const double phase = juce::MathConstants<double>::twoPi * n / kernelLength;
+        window[static_cast<size_t>(n)] = static_cast<float>(0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase));
+    }
+
+    convolutions.clear();
+    for (int first = 0; first < numChannels; first += 2) {
+        juce::dsp::Convolution* convolution = convolutions.add(new juce::dsp::Convolution(juce::dsp::Convolution::Latency{ partitionSize }, *loadQueue));
+        convolution->prepare({ sampleRate, static_cast<juce::uint32>(maxBlockSize), static_cast<juce::uint32>(juce::jmin(2, numChannels - first)) });
+    }
+
+    latencySamples.store(half + (convolutions.isEmpty() ? 0 : convolutions.getFirst()->getLatency()));
+}
+
+void LinearPhaseEngine::reset() noexcept {
+    for (juce::dsp::Convolution* convolution : convolutions)
+        convolution->reset();
+}
+
+void LinearPhaseEngine::process(const juce::dsp::AudioBlock<float>& block) noexcept {
+    const int numChannels = static_cast<int>(block.getNumChannels());
+
+    for (int pair = 0; pair < convolutions.size() && pair * 2 < numChannels; ++pair) {
+        const int first = pair * 2;
+        juce::dsp::AudioBlock<float> channels = block.getSubsetChannelBlock(static_cast<size_t>(first), static_cast<size_t>(juce::jmin(2, numChannels - first)));
+
+        juce::dsp::ProcessContextReplacing<float> context(channels);
+        convolutions.getUnchecked(pair)->process(context);
+    }
+}
+
+void LinearPhaseEngine::coefficientsDesigned(const EQCoefficients& coefficients) {
+    if (!coefficients.settings.linearPhase)
+        return;
+
+    const juce::ScopedLock sl(designLock);
+
+    // Sets designed for the oversampled IIR path are fine too (and free of
+    // bilinear cramping), as long as they are for a whole multiple of our rate.
+    const double ratio = sampleRate > 0.0 ? coefficients.sampleRate / sampleRate : 0.0;
+    if (kernelLength == 0 || ratio < 1.0 || std::abs(ratio - std::round(ratio)) > 1.0e-6)
+        return;
+
+    if (coefficients.sampleRate != tableSampleRate)
+        updateFrequencyTables(coefficients.sampleRate);
+
+    designKernel(coefficients);
+
+    // Each engine takes ownership of its own copy; the swap is crossfaded inside Convolution.
+    for (juce::dsp::Convolution* convolution : convolutions)
+        convolution->loadImpulseResponse(juce::AudioBuffer<float>(kernel), sampleRate,
+                                         juce::dsp::Convolution::Stereo::no, juce::dsp::Convolution::Trim::no,
+                                         juce::dsp::Convolution::Normalise::no);
+}
+
+void LinearPhaseEngine::updateFrequencyTables(double designSampleRate) {
+    tableSampleRate = designSampleRate;
+
+    // Bin frequencies of the kernel, as angles at the rate the coefficients were designed for.
+    for (size_t bin = 0; bin < cosTable.size(); ++bin) {
+        const double omega = juce::MathConstants<double>::twoPi * static_cast<double>(bin) / kernelLength * sampleRate / designSampleRate;
+        cosTable[bin] = std::cos(omega);
+        sinTable[bin] = std::sin(omega);
+    }
+}
+
+void LinearPhaseEngine::designKernel(const EQCoefficients& coefficients) {
+    const int half = kernelLength / 2;
+    const double outputGain = juce::Decibels::decibelsToGain(static_cast<double>(coefficients.settings.outputGain));
+
+    // Zero-phase spectrum: the combined magnitude of every active section,
+    // with the output gain folded in.
+    for (int bin = 0; bin <= half; ++bin) {
+        const double c1 = cosTable[static_cast<size_t>(bin)];
+        const double s1 = sinTable[static_cast<size_t>(bin)];
+        const double c2 = 2.0 * c1 * c1 - 1.0;
+        const double s2 = 2.0 * s1 * c1;
+
+        double power = 1.0;
+
+        for (const BandCoefficients& band : coefficients.bands) {
+            for (int section = 0; section < band.numSections; ++section) {
+                const BiquadCoefficients& c = band.sections[static_cast<size_t>(section)];
+
+                const double numeratorReal = c.b0 + c.b1 * c1 + c.b2 * c2;
+                const double numeratorImag = -(c.b1 * s1 + c.b2 * s2);
+                const double denominatorReal = 1.0 + c.a1 * c1 + c.a2 * c2;
+                const double denominatorImag = -(c.a1 * s1 + c.a2 * s2);
+
+                power *= (numeratorReal * numeratorReal + numeratorImag * numeratorImag)
+                       / (denominatorReal * denominatorReal + denominatorImag * denominatorImag);
+            }
+        }
+
+        spectrum[static_cast<size_t>(bin * 2)] = static_cast<float>(std::sqrt(power) * outputGain);
+        spectrum[static_cast<size_t>(bin * 2 + 1)] = 0.0f;
+    }
+
+    std::fill(spectrum.begin() + (half + 1) * 2, spectrum.end(), 0.0f);
+
+    fft->performRealOnlyInverseTransform(spectrum.data());
+
+    // The impulse is centred on sample 0 and wraps around; rotate it to the
+    // middle of the kernel and taper the truncated ends.
+    float* output = kernel.getWritePointer(0);
+    for (int n = 0; n < kernelLength; ++n)
+        output[n] = spectrum[static_cast<size_t>((n + half) % kernelLength)] * window[static_cast<size_t>(n)];
+}
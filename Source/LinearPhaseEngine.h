@@ -0,0 +1,68 @@
+/*
+  ==============================================================================
+
+    LinearPhaseEngine.h
+
+    Linear-phase version of the EQ curve. A symmetric FIR is derived from the
+    combined magnitude response of every band whenever the coefficient
+    pipeline designs a new set, and run through uniformly partitioned FFT
+    convolution. juce::dsp::Convolution crossfades to each new kernel.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "CoefficientPipeline.h"
+
+//==============================================================================
+// Background thread that turns new kernels into partitioned spectra, shared
+// by every linear-phase engine in the process.
+struct ConvolutionLoadQueue : juce::dsp::ConvolutionMessageQueue {
+};
+
+//==============================================================================
+class LinearPhaseEngine : public CoefficientPipeline::Listener {
+public:
+    static constexpr int partitionSize = 512;
+
+    LinearPhaseEngine() = default;
+
+    void prepare(double sampleRate, int maxBlockSize, int numChannels);
+    void reset() noexcept;
+
+    // Audio thread. Channels are processed in pairs; each pair shares one
+    // convolution engine running the same mono kernel.
+    void process(const juce::dsp::AudioBlock<float>& block) noexcept;
+
+    // Half the kernel (the FIR's centre) plus the partitioning delay.
+    int getLatencySamples() const noexcept { return latencySamples.load(std::memory_order_relaxed); }
+
+    // Long enough for ~3 Hz resolution at any rate; doubles with the sample rate.
+    static int getKernelLength(double sampleRate) noexcept;
+
+    // Design thread. Only does work while linear-phase mode is switched on.
+    void coefficientsDesigned(const EQCoefficients& coefficients) override;
+
+private:
+    void updateFrequencyTables(double designSampleRate);
+    void designKernel(const EQCoefficients& coefficients);
+
+    juce::SharedResourcePointer<ConvolutionLoadQueue> loadQueue;
+    juce::OwnedArray<juce::dsp::Convolution> convolutions;
+    std::atomic<int> latencySamples{ 0 };
+
+    // Design state, guarded by designLock.
+    juce::CriticalSection designLock;
+    double sampleRate{ 0.0 };
+    int kernelLength{ 0 };
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::vector<float> spectrum;                // interleaved complex, as the real-only FFT expects
+    std::vector<double> cosTable, sinTable;     // e^-jw per bin
+    double tableSampleRate{ 0.0 };              // the coefficient rate the tables were built for
+    std::vector<float> window;
+    juce::AudioBuffer<float> kernel;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LinearPhaseEngine)
+};
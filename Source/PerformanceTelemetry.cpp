@@ -0,0 +1,158 @@
+/*
+  ==============================================================================
+
+    PerformanceTelemetry.cpp
+
+  ==============================================================================
+*/
+
+#include "PerformanceTelemetry.h"
+
+double PerformanceTelemetry::Snapshot::getPercentileMicroseconds(double fraction) const noexcept {
+    const double target = fraction * static_cast<double>(blocks);
+    juce::int64 count = 0;
+
+    for (int bucket = 0; bucket < numHistogramBuckets; ++bucket) {
+        count += histogram[static_cast<size_t>(bucket)];
+        if (count > 0 && static_cast<double>(count) >= target)
+            return getBucketEndMicroseconds(bucket);
+    }
+
+    return 0.0;
+}
+
+PerformanceTelemetry::Snapshot PerformanceTelemetry::Snapshot::since(const Snapshot& earlier) const noexcept {
+    Snapshot result = *this;
+
+    // A reset in between leaves the counters below the earlier ones.
+    if (blocks < earlier.blocks)
+        return result;
+
+    result.blocks -= earlier.blocks;
+    result.samples -= earlier.samples;
+    result.overruns -= earlier.overruns;
+    result.updateSeconds -= earlier.updateSeconds;
+    result.processSeconds -= earlier.processSeconds;
+    result.audioSeconds -= earlier.audioSeconds;
+
+    for (size_t bucket = 0; bucket < histogram.size(); ++bucket)
+        result.histogram[bucket] -= earlier.histogram[bucket];
+
+    return result;
+}
+
+//==============================================================================
+void PerformanceTelemetry::prepare(double newSampleRate) noexcept {
+    sampleRate.store(newSampleRate > 0.0 ? newSampleRate : 44100.0, std::memory_order_relaxed);
+    clear();
+}
+
+void PerformanceTelemetry::clear() noexcept {
+    resetRequested.store(false, std::memory_order_relaxed);
+    blocks.store(0, std::memory_order_relaxed);
+    samples.store(0, std::memory_order_relaxed);
+    overruns.store(0, std::memory_order_relaxed);
+    updateTicks.store(0, std::memory_order_relaxed);
+    processTicks.store(0, std::memory_order_relaxed);
+    maxBlockTicks.store(0, std::memory_order_relaxed);
+    maxLoad.store(0.0, std::memory_order_relaxed);
+
+    for (std::atomic<juce::int64>& bucket : histogram)
+        bucket.store(0, std::memory_order_relaxed);
+}
+
+void PerformanceTelemetry::recordBlock(int numSamples, juce::int64 startTicks, juce::int64 updatedTicks, juce::int64 endTicks) noexcept {
+    if (resetRequested.load(std::memory_order_relaxed))
+        clear();
+
+    if (numSamples <= 0)
+        return;
+
+    const juce::int64 blockTicks = endTicks - startTicks;
+    const double blockSeconds = static_cast<double>(blockTicks) * secondsPerTick;
+    const double load = blockSeconds * sampleRate.load(std::memory_order_relaxed) / numSamples;
+    const double microseconds = blockSeconds * 1.0e6;
+
+    const int bucket = microseconds < 2.0 ? 0 : juce::jmin(numHistogramBuckets - 1, static_cast<int>(std::log2(microseconds)));
+
+    add(blocks, juce::int64(1));
+    add(samples, static_cast<juce::int64>(numSamples));
+    add(updateTicks, updatedTicks - startTicks);
+    add(processTicks, endTicks - updatedTicks);
+    add(histogram[static_cast<size_t>(bucket)], juce::int64(1));
+    raise(maxBlockTicks, blockTicks);
+    raise(maxLoad, load);
+
+    if (load > 1.0)
+        add(overruns, juce::int64(1));
+}
+
+PerformanceTelemetry::Snapshot PerformanceTelemetry::getSnapshot() const noexcept {
+    Snapshot snapshot;
+    snapshot.blocks = blocks.load(std::memory_order_relaxed);
+    snapshot.samples = samples.load(std::memory_order_relaxed);
+    snapshot.overruns = overruns.load(std::memory_order_relaxed);
+    snapshot.updateSeconds = static_cast<double>(updateTicks.load(std::memory_order_relaxed)) * secondsPerTick;
+    snapshot.processSeconds = static_cast<double>(processTicks.load(std::memory_order_relaxed)) * secondsPerTick;
+    snapshot.audioSeconds = static_cast<double>(snapshot.samples) / sampleRate.load(std::memory_order_relaxed);
+    snapshot.maxBlockSeconds = static_cast<double>(maxBlockTicks.load(std::memory_order_relaxed)) * secondsPerTick;
+    snapshot.maxLoad = maxLoad.load(std::memory_order_relaxed);
+
+    for (size_t bucket = 0; bucket < histogram.size(); ++bucket)
+        snapshot.histogram[bucket] = histogram[bucket].load(std::memory_order_relaxed);
+
+    return snapshot;
+}
+
+//==============================================================================
+TelemetryLogThread::TelemetryLogThread() : juce::TimeSliceThread("EQ Telemetry Log") {
+    startThread();
+}
+
+TelemetryLogThread::~TelemetryLogThread() {
+    stopThread(1000);
+}
+
+//==============================================================================
+TelemetryLog::TelemetryLog(const PerformanceTelemetry& source, const juce::File& file, int interval,
+                           std::function<juce::String()> describe)
+    : telemetry(source), logFile(file), intervalMs(juce::jmax(100, interval)), describeSettings(std::move(describe)) {
+    logThread->addTimeSliceClient(this);
+}
+
+TelemetryLog::~TelemetryLog() {
+    logThread->removeTimeSliceClient(this);
+}
+
+int TelemetryLog::useTimeSlice() {
+    const PerformanceTelemetry::Snapshot current = telemetry.getSnapshot();
+
+    // The first slice only sets the baseline.
+    if (!started) {
+        started = true;
+        previous = current;
+        return intervalMs;
+    }
+
+    const PerformanceTelemetry::Snapshot interval = current.since(previous);
+    previous = current;
+
+    if (interval.blocks == 0)
+        return intervalMs;
+
+    const double busySeconds = interval.updateSeconds + interval.processSeconds;
+
+    juce::String line;
+    line << juce::Time::getCurrentTime().toISO8601(true)
+         << "  blocks " << interval.blocks
+         << "  overruns " << interval.overruns
+         << "  load " << juce::String(100.0 * interval.getMeanLoad(), 2) << "%"
+         << "  p99 <= " << juce::String(interval.getPercentileMicroseconds(0.99), 0) << " us"
+         << "  slowest <= " << juce::String(interval.getPercentileMicroseconds(1.0), 0) << " us"
+         << "  updateFilters " << juce::String(busySeconds > 0.0 ? 100.0 * interval.updateSeconds / busySeconds : 0.0, 1) << "%"
+         << "  | " << (describeSettings != nullptr ? describeSettings() : juce::String())
+         << juce::newLine;
+
+    logFile.appendText(line, false, false, nullptr);
+    return intervalMs;
+}
@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+    PerformanceTelemetry.h
+
+    What processBlock costs, measured on the audio thread: a histogram of
+    per-block CPU time, the split between picking up coefficients and
+    filtering, and CPU time as a share of the block's duration, with a count
+    of blocks that took longer than they last. The audio thread is the only
+    writer and updates each counter with a plain load and store, so recording
+    is wait-free; readers see each counter atomically but not all of them at
+    the same instant.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+class PerformanceTelemetry {
+public:
+    // Bucket n counts blocks taking [2^n, 2^(n+1)) microseconds; the first
+    // also takes anything faster and the last anything slower.
+    static constexpr int numHistogramBuckets = 16;
+
+    struct Snapshot {
+        juce::int64 blocks{ 0 };
+        juce::int64 samples{ 0 };
+        juce::int64 overruns{ 0 };          // blocks whose CPU time exceeded their duration
+        double updateSeconds{ 0.0 };        // in updateFilters
+        double processSeconds{ 0.0 };       // everything after it
+        double audioSeconds{ 0.0 };         // duration of the blocks processed
+        double maxBlockSeconds{ 0.0 };
+        double maxLoad{ 0.0 };              // CPU time / block duration
+        std::array<juce::int64, numHistogramBuckets> histogram{};
+
+        double getMeanLoad() const noexcept { return audioSeconds > 0.0 ? (updateSeconds + processSeconds) / audioSeconds : 0.0; }
+
+        // Upper edge of the bucket holding the given fraction of blocks.
+        double getPercentileMicroseconds(double fraction) const noexcept;
+
+        // Counters accumulated since an earlier snapshot; the maxima can't be
+        // split and are kept as they are.
+        Snapshot since(const Snapshot& earlier) const noexcept;
+    };
+
+    static double getBucketEndMicroseconds(int bucket) noexcept { return static_cast<double>(juce::int64(2) << bucket); }
+
+    void prepare(double sampleRate) noexcept;
+
+    // Any thread. The audio thread clears the counters at its next block.
+    void requestReset() noexcept { resetRequested.store(true, std::memory_order_relaxed); }
+
+    // Audio thread only. Ticks from juce::Time::getHighResolutionTicks().
+    void recordBlock(int numSamples, juce::int64 startTicks, juce::int64 updatedTicks, juce::int64 endTicks) noexcept;
+
+    Snapshot getSnapshot() const noexcept;
+
+private:
+    template <typename Type>
+    static void add(std::atomic<Type>& counter, Type amount) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    template <typename Type>
+    static void raise(std::atomic<Type>& counter, Type value) noexcept {
+        if (value > counter.load(std::memory_order_relaxed))
+            counter.store(value, std::memory_order_relaxed);
+    }
+
+    void clear() noexcept;
+
+    std::atomic<double> sampleRate{ 44100.0 };
+    double secondsPerTick{ 1.0 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()) };
+
+    std::atomic<bool> resetRequested{ false };
+    std::atomic<juce::int64> blocks{ 0 }, samples{ 0 }, overruns{ 0 };
+    std::atomic<juce::int64> updateTicks{ 0 }, processTicks{ 0 }, maxBlockTicks{ 0 };
+    std::atomic<double> maxLoad{ 0.0 };
+    std::array<std::atomic<juce::int64>, numHistogramBuckets> histogram{};
+};
+
+//==============================================================================
+// One low-priority thread shared by every telemetry log in the process.
+struct TelemetryLogThread : juce::TimeSliceThread {
+    TelemetryLogThread();
+    ~TelemetryLogThread() override;
+};
+
+//==============================================================================
+// Appends one line per interval to a text file: what changed in the counters
+// since the last line, next to a description of the settings at the time, so
+// overruns can be matched to what the plugin was doing.
+class TelemetryLog : private juce::TimeSliceClient {
+public:
+    TelemetryLog(const PerformanceTelemetry& telemetry, const juce::File& logFile, int intervalMs,
+                 std::function<juce::String()> describeSettings);
+    ~TelemetryLog() override;
+
+    const juce::File& getFile() const noexcept { return logFile; }
+
+private:
+    int useTimeSlice() override;
+
+    const PerformanceTelemetry& telemetry;
+    const juce::File logFile;
+    const int intervalMs;
+    const std::function<juce::String()> describeSettings;
+
+    juce::SharedResourcePointer<TelemetryLogThread> logThread;
+    PerformanceTelemetry::Snapshot previous;
+    bool started{ false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TelemetryLog)
+};
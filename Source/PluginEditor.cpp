@@ -9,15 +9,70 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
+// Drops points that lie within tolerance pixels of the straight line the
+// kept points already describe, so smooth stretches cost a few segments
+// instead of one per grid point. Keeps a cone of slopes from the last kept
+// point that passes within tolerance of every point since; a point outside
+// it ends the segment. x must increase from point to point.
+static juce::Path makeDecimatedPath(const float* values, int numValues, float left, float xStep,
+                                    float minimum, float maximum, float bottom, float top, float tolerance) {
+    juce::Path path;
+    if (numValues <= 0)
+        return path;
+
+    // Off-scale values (a notch's -inf dB) are pinned just outside the area.
+    const float span = bottom - top;
+    auto yAt = [&](int index) { return juce::jlimit(top - span, bottom + span, juce::jmap(values[index], minimum, maximum, bottom, top)); };
+
+    float anchorX = left, anchorY = yAt(0);
+    float lastX = anchorX, lastY = anchorY;
+    float lowSlope = -std::numeric_limits<float>::max(), highSlope = std::numeric_limits<float>::max();
+
+    path.preallocateSpace(numValues * 3);
+    path.startNewSubPath(anchorX, anchorY);
+
+    for (int index = 1; index < numValues; ++index) {
+        const float x = left + static_cast<float>(index) * xStep;
+        const float y = yAt(index);
+        float dx = x - anchorX;
+        const float slope = (y - anchorY) / dx;
+
+        if (slope < lowSlope || slope > highSlope) {
+            path.lineTo(lastX, lastY);
+            anchorX = lastX;
+            anchorY = lastY;
+            dx = x - anchorX;
+            lowSlope = -std::numeric_limits<float>::max();
+            highSlope = std::numeric_limits<float>::max();
+        }
+
+        lowSlope = juce::jmax(lowSlope, (y - tolerance - anchorY) / dx);
+        highSlope = juce::jmin(highSlope, (y + tolerance - anchorY) / dx);
+        lastX = x;
+        lastY = y;
+    }
+
+    path.lineTo(lastX, lastY);
+    return path;
+}
+
+static juce::Rectangle<int> getStrokeBounds(const juce::Path& path) {
+    return path.isEmpty() ? juce::Rectangle<int>() : path.getBounds().expanded(2.0f).getSmallestIntegerContainer();
+}
+
+//==============================================================================
 ResponseCurveComponent::ResponseCurveComponent(EqualizerAudioProcessor& p) : audioProcessor(p) {
     const auto& params = audioProcessor.getParameters();
     for (auto param : params)
         param->addListener(this);
 
-    startTimerHz(60);
+    // The background image covers every pixel.
+    setOpaque(true);
 }
 
 ResponseCurveComponent::~ResponseCurveComponent() {
+    audioProcessor.getAnalyzer().setEnabled(false);
+
     auto& params = audioProcessor.getParameters();
     for (auto param : params) {
         param->removeListener(this);
@@ -25,103 +80,318 @@ ResponseCurveComponent::~ResponseCurveComponent() {
 }
 
 void ResponseCurveComponent::parameterValueChanged(int parameterIndex, float newValue) {
+    // May be called from the audio thread during automation, so only raise a flag.
     parametersChanged.set(true);
+}
+
+void ResponseCurveComponent::wake() {
+    if (!isShowing())
+        return;
 
+    audioProcessor.getAnalyzer().setEnabled(true);
+    idleFrames = 0;
+    setTimerRate(true);
+}
+
+void ResponseCurveComponent::visibilityChanged() {
+    wake();
+}
+
+void ResponseCurveComponent::setTimerRate(bool active) {
+    if (isTimerRunning() && active == timerIsActive)
+        return;
+
+    timerIsActive = active;
+    startTimerHz(active ? activeRateHz : idleRateHz);
 }
 
 void ResponseCurveComponent::timerCallback() {
+    // Nothing to draw for; wake() starts everything again.
+    if (!isShowing()) {
+        stopTimer();
+        timerIsActive = false;
+        audioProcessor.getAnalyzer().setEnabled(false);
+        return;
+    }
+
+    bool changed = false;
+
     if (parametersChanged.compareAndSetBool(false, true)) {
         const ChainSettings& chainSettings = getChainSettings(audioProcessor.apvts);
 
-        auto [peak1Coefficients, peak2Coefficients] = makePeakFilters(chainSettings, audioProcessor.getSampleRate());
-        channelEQ.get<ChainPositions::PeakBand1>().coefficients = *peak1Coefficients;
-        channelEQ.get<ChainPositions::PeakBand2>().coefficients = *peak2Coefficients;
+        // The editor can open before the host has prepared the processor.
+        const double sampleRate = audioProcessor.getSampleRate() > 0.0 ? audioProcessor.getSampleRate() : 44100.0;
 
-        auto lowCutCoefficients = makeLowCutFilter(chainSettings, audioProcessor.getSampleRate());
-        auto highCutCoefficients = makeHighCutFilter(chainSettings, audioProcessor.getSampleRate());
-        applyCutFilterCoefficients(channelEQ.get<ChainPositions::LowCut>(), lowCutCoefficients, chainSettings.lowCutSlope);
-        applyCutFilterCoefficients(channelEQ.get<ChainPositions::HighCut>(), highCutCoefficients, chainSettings.highCutSlope);
+        // Designed at the oversampled rate when oversampling is on, like the audio path.
+        // Only the bands whose coefficients moved are re-evaluated.
+        if (curveCache.update(designEQCoefficients(chainSettings, getProcessingSampleRate(chainSettings, sampleRate), coefficientCache))) {
+            rebuildCurvePaths();
+            changed = true;
+        }
+    }
 
-        repaint();
+    if (updateSpectra()) {
+        rebuildSpectrumPaths();
+        changed = true;
     }
+
+    idleFrames = changed ? 0 : idleFrames + 1;
+    setTimerRate(idleFrames < framesBeforeIdle);
 }
 
-void ResponseCurveComponent::paint(juce::Graphics& g)
-{
-    // (Our component is opaque, so we must completely fill the background with a solid colour)
-    //g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
-    g.fillAll(juce::Colour::fromRGBA(86, 91, 90, 255));
+// Returns false when there's no new frame or it matches the last one, as
+// it does once the input is silent and the peaks have decayed.
+bool ResponseCurveComponent::updateSpectra() {
+    SpectrumAnalyzer& analyzer = audioProcessor.getAnalyzer();
+    const int analyzerFrame = analyzer.getFrameCounter();
 
-    juce::Rectangle<int> responseArea = getLocalBounds();
+    if (analyzerFrame == lastAnalyzerFrame)
+        return false;
 
-    int width = responseArea.getWidth();
+    lastAnalyzerFrame = analyzerFrame;
 
-    IIRFilter& peak1 = channelEQ.get<ChainPositions::PeakBand1>();
-    IIRFilter& peak2 = channelEQ.get<ChainPositions::PeakBand2>();
-    BandFilter& lowCut = channelEQ.get<ChainPositions::LowCut>();
-    BandFilter& highCut = channelEQ.get<ChainPositions::HighCut>();
+    if (!analyzer.copyFrame(SpectrumAnalyzer::Pre, newPreSpectrum, newPrePeaks)
+        || !analyzer.copyFrame(SpectrumAnalyzer::Post, newPostSpectrum, newPostPeaks))
+        return false;
 
-    double sampleRate = audioProcessor.getSampleRate();
-    std::vector<double> magnitudes;
-    magnitudes.resize(width);
-    for (int i = 0; i < width; ++i) {
-        double magnitude = 1.0;
-        double frequency = juce::mapToLog10((double)i / (double)width, 20.0, 20000.0);
+    if (newPreSpectrum == preSpectrum && newPostSpectrum == postSpectrum && newPostPeaks == postPeaks)
+        return false;
 
-        if (!channelEQ.isBypassed<ChainPositions::PeakBand1>()) {
-            magnitude *= peak1.coefficients->getMagnitudeForFrequency(frequency, sampleRate);
-        }
+    preSpectrum.swap(newPreSpectrum);
+    prePeaks.swap(newPrePeaks);
+    postSpectrum.swap(newPostSpectrum);
+    postPeaks.swap(newPostPeaks);
+    return true;
+}
 
-        if (!channelEQ.isBypassed<ChainPositions::PeakBand2>()) {
-            magnitude *= peak2.coefficients->getMagnitudeForFrequency(frequency, sampleRate);
-        }
+void ResponseCurveComponent::rebuildCurvePaths() {
+    const juce::Rectangle<int> previousBounds = curveBounds;
+    const juce::Rectangle<float> area = getLocalBounds().toFloat();
+    const int numPoints = curveCache.getNumPoints();
 
-        if (!lowCut.isBypassed<0>()) {
-            magnitude *= lowCut.get<0>().coefficients->getMagnitudeForFrequency(frequency, sampleRate);
-        }
-        if (!lowCut.isBypassed<1>()) {
-            magnitude *= lowCut.get<1>().coefficients->getMagnitudeForFrequency(frequency, sampleRate);
-        }
-        if (!lowCut.isBypassed<2>()) {
-            magnitude *= lowCut.get<2>().coefficients->getMagnitudeForFrequency(frequency, sampleRate);
-        }
-        if (!lowCut.isBypassed<3>()) {
-            magnitude *= lowCut.get<3>().coefficients->getMagnitudeForFrequency(frequency, sampleRate);
-        }
+    magnitudePath.clear();
+    phasePath.clear();
+    for (juce::Path& path : bandPaths)
+        path.clear();
 
-        if (!highCut.isBypassed<0>()) {
-            magnitude *= highCut.get<0>().coefficients->getMagnitudeForFrequency(frequency, sampleRate);
-        }
-        if (!highCut.isBypassed<1>()) {
-            magnitude *= highCut.get<1>().coefficients->getMagnitudeForFrequency(frequency, sampleRate);
+    curveBounds = {};
+
+    if (numPoints > 1 && !area.isEmpty()) {
+        // Grid points are evenly spaced in log frequency, so they map linearly onto the x axis.
+        const float xStep = area.getWidth() / static_cast<float>(numPoints - 1);
+        auto makeCurve = [&](const float* values, float minimum, float maximum) {
+            return makeDecimatedPath(values, numPoints, area.getX(), xStep, minimum, maximum, area.getBottom(), area.getY(), decimationTolerance);
+        };
+
+        magnitudePath = makeCurve(curveCache.getTotalMagnitude(), -18.0f, 18.0f);
+        curveBounds = getStrokeBounds(magnitudePath);
+
+        if (showPhase) {
+            phasePath = makeCurve(curveCache.getTotalPhase(), -juce::MathConstants<float>::pi, juce::MathConstants<float>::pi);
+            curveBounds = curveBounds.getUnion(getStrokeBounds(phasePath));
         }
-        if (!highCut.isBypassed<2>()) {
-            magnitude *= highCut.get<2>().coefficients->getMagnitudeForFrequency(frequency, sampleRate);
+
+        if (showBandCurves) {
+            for (int band = 0; band < EQCoefficients::numBands; ++band) {
+                if (!curveCache.isBandActive(band))
+                    continue;
+
+                juce::Path& path = bandPaths[static_cast<size_t>(band)];
+                path = makeCurve(curveCache.getBandMagnitude(band), -18.0f, 18.0f);
+                curveBounds = curveBounds.getUnion(getStrokeBounds(path));
+            }
         }
-        if (!highCut.isBypassed<3>()) {
-            magnitude *= highCut.get<3>().coefficients->getMagnitudeForFrequency(frequency, sampleRate);
+    }
+
+    repaint(previousBounds.getUnion(curveBounds));
+}
+
+void ResponseCurveComponent::rebuildSpectrumPaths() {
+    const juce::Rectangle<int> previousBounds = spectrumBounds;
+    const juce::Rectangle<float> area = getLocalBounds().toFloat();
+
+    // One level per pixel column; filled spectra reach down to the bottom edge.
+    auto makeSpectrum = [&](juce::Path& path, const std::vector<float>& levels, bool filled) {
+        path.clear();
+        if (levels.empty() || levels.size() != static_cast<size_t>(getWidth()))
+            return;
+
+        path = makeDecimatedPath(levels.data(), static_cast<int>(levels.size()), area.getX(), 1.0f,
+                                 SpectrumAnalyzer::minDecibels, 0.0f, area.getBottom(), area.getY(), decimationTolerance);
+
+        if (filled) {
+            path.lineTo(area.getRight(), area.getBottom());
+            path.lineTo(area.getX(), area.getBottom());
+            path.closeSubPath();
         }
+    };
 
-        magnitudes[i] = juce::Decibels::gainToDecibels(magnitude);
+    makeSpectrum(preSpectrumPath, preSpectrum, true);
+    makeSpectrum(postSpectrumPath, postSpectrum, true);
+    makeSpectrum(postPeakPath, postPeaks, false);
+
+    spectrumBounds = getStrokeBounds(preSpectrumPath).getUnion(getStrokeBounds(postSpectrumPath)).getUnion(getStrokeBounds(postPeakPath));
+    repaint(previousBounds.getUnion(spectrumBounds));
+}
+
+void ResponseCurveComponent::renderBackground(float scale) {
+    backgroundScale = scale;
+    background = juce::Image(juce::Image::RGB, juce::jmax(1, juce::roundToInt(getWidth() * scale)), juce::jmax(1, juce::roundToInt(getHeight() * scale)), false);
+
+    juce::Graphics g(background);
+    g.addTransform(juce::AffineTransform::scale(scale));
+
+    const juce::Rectangle<float> area = getLocalBounds().toFloat();
+    g.setColour(juce::Colours::black);
+    g.fillRect(area);
+
+    g.setFont(10.0f);
+
+    for (const float frequency : { 20.0f, 50.0f, 100.0f, 200.0f, 500.0f, 1000.0f, 2000.0f, 5000.0f, 10000.0f, 20000.0f }) {
+        const float x = area.getX() + area.getWidth() * juce::mapFromLog10(frequency, static_cast<float>(ResponseCurveCache::minFrequency), static_cast<float>(ResponseCurveCache::maxFrequency));
+
+        g.setColour(juce::Colours::white.withAlpha(0.12f));
+        g.drawVerticalLine(juce::roundToInt(x), area.getY(), area.getBottom());
+
+        g.setColour(juce::Colours::lightgrey.withAlpha(0.6f));
+        const juce::String label = frequency >= 1000.0f ? juce::String(frequency / 1000.0f) + "k" : juce::String(frequency);
+        g.drawText(label, juce::Rectangle<float>(x + 2.0f, area.getBottom() - 14.0f, 30.0f, 12.0f), juce::Justification::centredLeft);
     }
 
-    juce::Path responseCurve;
-    const double outputMin = responseArea.getBottom();
-    const double outputMax = responseArea.getY();
-    auto map = [outputMin, outputMax](double input) {
-        return juce::jmap<double>(input, -18.0, 18.0, outputMin, outputMax);
+    for (const float gain : { -12.0f, -6.0f, 0.0f, 6.0f, 12.0f }) {
+        const float y = juce::jmap(gain, -18.0f, 18.0f, area.getBottom(), area.getY());
+
+        g.setColour(juce::Colours::white.withAlpha(gain == 0.0f ? 0.3f : 0.12f));
+        g.drawHorizontalLine(juce::roundToInt(y), area.getX(), area.getRight());
+
+        g.setColour(juce::Colours::lightgrey.withAlpha(0.6f));
+        g.drawText((gain > 0.0f ? "+" : "") + juce::String(gain, 0), juce::Rectangle<float>(area.getX() + 2.0f, y - 12.0f, 30.0f, 12.0f), juce::Justification::centredLeft);
+    }
+}
+
+void ResponseCurveComponent::resized() {
+    audioProcessor.getAnalyzer().setDisplayRange(getWidth(), ResponseCurveCache::minFrequency, ResponseCurveCache::maxFrequency);
+
+    background = {};
+    rebuildCurvePaths();
+    rebuildSpectrumPaths();
+    repaint();
+}
+
+void ResponseCurveComponent::setShowBandCurves(bool shouldShow) {
+    showBandCurves = shouldShow;
+    rebuildCurvePaths();
+}
+
+void ResponseCurveComponent::setShowPhase(bool shouldShow) {
+    showPhase = shouldShow;
+
+    curveCache.setPhaseEnabled(shouldShow);
+    parametersChanged.set(true);
+    rebuildCurvePaths();
+    wake();
+}
+
+void ResponseCurveComponent::paint(juce::Graphics& g)
+{
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (background.isNull() || scale != backgroundScale)
+        renderBackground(scale);
+
+    g.drawImage(background, getLocalBounds().toFloat());
+
+    // Spectra go behind the curves.
+    g.setColour(juce::Colours::grey.withAlpha(0.35f));
+    g.fillPath(preSpectrumPath);
+    g.setColour(juce::Colours::dodgerblue.withAlpha(0.35f));
+    g.fillPath(postSpectrumPath);
+    g.setColour(juce::Colours::dodgerblue.withAlpha(0.6f));
+    g.strokePath(postPeakPath, juce::PathStrokeType(1.f));
+
+    if (showBandCurves) {
+        static const juce::Colour legacyColours[ChainPositions::FirstExtraBand] = {
+            juce::Colours::skyblue, juce::Colours::orange, juce::Colours::limegreen, juce::Colours::hotpink
         };
 
-    responseCurve.startNewSubPath(responseArea.getX(), map(magnitudes.front()));
-    for (int i = 0; i < magnitudes.size(); ++i) {
-        responseCurve.lineTo(responseArea.getX() + i, map(magnitudes[i]));
+        for (int band = 0; band < EQCoefficients::numBands; ++band) {
+            const juce::Path& path = bandPaths[static_cast<size_t>(band)];
+            if (path.isEmpty())
+                continue;
+
+            // Extra bands walk round the hue circle so neighbours stay distinguishable.
+            const juce::Colour colour = band < ChainPositions::FirstExtraBand
+                ? legacyColours[band]
+                : juce::Colour::fromHSV(std::fmod(static_cast<float>(band - ChainPositions::FirstExtraBand) * 0.382f, 1.0f), 0.6f, 1.0f, 1.0f);
+
+            g.setColour(colour.withAlpha(0.6f));
+            g.strokePath(path, juce::PathStrokeType(1.f));
+        }
     }
 
-    g.setColour(juce::Colours::black);
-    g.fillRect(responseArea);
+    if (showPhase) {
+        g.setColour(juce::Colours::yellow.withAlpha(0.5f));
+        g.strokePath(phasePath, juce::PathStrokeType(1.f));
+    }
+
+    g.setColour(juce::Colours::white);
+    g.strokePath(magnitudePath, juce::PathStrokeType(1.f));
+}
+
+//==============================================================================
+TelemetryOverlay::TelemetryOverlay(EqualizerAudioProcessor& p) : audioProcessor(p) {
+}
+
+void TelemetryOverlay::visibilityChanged() {
+    if (isVisible())
+        startTimerHz(4);
+    else
+        stopTimer();
+}
+
+void TelemetryOverlay::mouseDown(const juce::MouseEvent&) {
+    audioProcessor.getTelemetry().requestReset();
+}
+
+void TelemetryOverlay::timerCallback() {
+    snapshot = audioProcessor.getTelemetry().getSnapshot();
+    repaint();
+}
+
+void TelemetryOverlay::paint(juce::Graphics& g) {
+    g.setColour(juce::Colours::black.withAlpha(0.75f));
+    g.fillRoundedRectangle(getLocalBounds().toFloat(), 4.0f);
+
+    juce::Rectangle<int> area = getLocalBounds().reduced(8);
+    const double busySeconds = snapshot.updateSeconds + snapshot.processSeconds;
+
+    const juce::StringArray lines{
+        "Blocks " + juce::String(snapshot.blocks) + "   overruns " + juce::String(snapshot.overruns),
+        "Load " + juce::String(100.0 * snapshot.getMeanLoad(), 2) + "%   max " + juce::String(100.0 * snapshot.maxLoad, 1) + "%",
+        "p99 <= " + juce::String(snapshot.getPercentileMicroseconds(0.99), 0) + " us   max " + juce::String(snapshot.maxBlockSeconds * 1.0e6, 0) + " us",
+        "updateFilters " + juce::String(busySeconds > 0.0 ? 100.0 * snapshot.updateSeconds / busySeconds : 0.0, 1) + "% of the time"
+    };
 
     g.setColour(juce::Colours::white);
-    g.strokePath(responseCurve, juce::PathStrokeType(1.f));
+    g.setFont(13.0f);
+    for (const juce::String& line : lines)
+        g.drawText(line, area.removeFromTop(16), juce::Justification::centredLeft);
+
+    // Block time histogram on a log2 microsecond axis.
+    area.removeFromTop(6);
+    const juce::Rectangle<int> labels = area.removeFromBottom(14);
+    const juce::int64 tallest = *std::max_element(snapshot.histogram.begin(), snapshot.histogram.end());
+    const float barWidth = static_cast<float>(area.getWidth()) / PerformanceTelemetry::numHistogramBuckets;
+
+    g.setColour(juce::Colours::orange);
+    for (int bucket = 0; bucket < PerformanceTelemetry::numHistogramBuckets && tallest > 0; ++bucket) {
+        const float height = static_cast<float>(area.getHeight()) * static_cast<float>(snapshot.histogram[static_cast<size_t>(bucket)]) / static_cast<float>(tallest);
+        g.fillRect(area.getX() + bucket * barWidth + 1.0f, area.getBottom() - height, barWidth - 2.0f, height);
+    }
+
+    g.setColour(juce::Colours::lightgrey);
+    g.setFont(11.0f);
+    g.drawText("2 us", labels, juce::Justification::centredLeft);
+    g.drawText(juce::String(PerformanceTelemetry::getBucketEndMicroseconds(PerformanceTelemetry::numHistogramBuckets - 2) / 1000.0, 0) + " ms+", labels, juce::Justification::centredRight);
 }
 
 //==============================================================================
@@ -135,7 +405,9 @@ EqualizerAudioProcessorEditor::EqualizerAudioProcessorEditor(EqualizerAudioProce
     peak2GainSliderAttachment(audioProcessor.apvts, "Peak2Gain", peak2GainSlider),
     peak2QualitySliderAttachment(audioProcessor.apvts, "Peak2Q", peak2QualitySlider),
     lowCutFrequencySliderAttachment(audioProcessor.apvts, "LowCutFreq", lowCutFrequencySlider),
-    highCutFrequencySliderAttachment(audioProcessor.apvts, "HighCutFreq", highCutFrequencySlider)
+    highCutFrequencySliderAttachment(audioProcessor.apvts, "HighCutFreq", highCutFrequencySlider),
+    telemetryOverlay(audioProcessor),
+    linearPhaseButtonAttachment(audioProcessor.apvts, "LinearPhase", linearPhaseButton)
 {
     addAndMakeVisible(&peak1FrequencySlider);
     addAndMakeVisible(&peak1GainSlider);
@@ -159,6 +431,57 @@ EqualizerAudioProcessorEditor::EqualizerAudioProcessorEditor(EqualizerAudioProce
     peak1QualityLabel.setText("Peak 1 Quality", juce::dontSendNotification);
     peak1QualityLabel.attachToComponent(&peak1QualitySlider, false);
 
+    addAndMakeVisible(bandCurvesButton);
+    bandCurvesButton.onClick = [this] { responseCurveComponent.setShowBandCurves(bandCurvesButton.getToggleState()); };
+
+    addAndMakeVisible(phaseButton);
+    phaseButton.onClick = [this] { responseCurveComponent.setShowPhase(phaseButton.getToggleState()); };
+
+    addAndMakeVisible(linearPhaseButton);
+
+    // Added after the response curve so it draws on top of it.
+    addChildComponent(telemetryOverlay);
+    addAndMakeVisible(telemetryButton);
+    telemetryButton.onClick = [this] { telemetryOverlay.setVisible(telemetryButton.getToggleState()); };
+
+    // The items have to exist before the attachment selects one.
+    if (juce::AudioParameterChoice* choice = dynamic_cast<juce::AudioParameterChoice*>(audioProcessor.apvts.getParameter("Oversampling")))
+        oversamplingBox.addItemList(choice->choices, 1);
+    oversamplingBoxAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(audioProcessor.apvts, "Oversampling", oversamplingBox);
+    addAndMakeVisible(oversamplingBox);
+
+    if (juce::AudioParameterChoice* choice = dynamic_cast<juce::AudioParameterChoice*>(audioProcessor.apvts.getParameter("StereoMode")))
+        stereoModeBox.addItemList(choice->choices, 1);
+    stereoModeBoxAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(audioProcessor.apvts, "StereoMode", stereoModeBox);
+    addAndMakeVisible(stereoModeBox);
+
+    for (int index = 0; index < audioProcessor.getNumPrograms(); ++index)
+        presetBox.addItem(audioProcessor.getProgramName(index), index + 1);
+    presetBox.setSelectedId(audioProcessor.getCurrentProgram() + 1, juce::dontSendNotification);
+    presetBox.onChange = [this] { audioProcessor.setCurrentProgram(presetBox.getSelectedId() - 1); };
+    addAndMakeVisible(presetBox);
+
+    // Storing a snapshot doesn't move anything; the slider only works once both exist.
+    storeAButton.onClick = [this] {
+        audioProcessor.storeMorphSnapshot(0);
+        morphSlider.setEnabled(audioProcessor.hasMorphSnapshots());
+    };
+    storeBButton.onClick = [this] {
+        audioProcessor.storeMorphSnapshot(1);
+        morphSlider.setEnabled(audioProcessor.hasMorphSnapshots());
+    };
+    addAndMakeVisible(storeAButton);
+    addAndMakeVisible(storeBButton);
+
+    morphSlider.setRange(0.0, 1.0);
+    morphSlider.setValue(audioProcessor.getMorphPosition(), juce::dontSendNotification);
+    morphSlider.setEnabled(audioProcessor.hasMorphSnapshots());
+    morphSlider.onValueChange = [this] { audioProcessor.setMorphPosition(static_cast<float>(morphSlider.getValue())); };
+    addAndMakeVisible(morphSlider);
+
+    // paint fills the whole editor, so nothing behind it needs redrawing.
+    setOpaque(true);
+
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
     setSize(1200, 1000);
@@ -186,6 +509,21 @@ void EqualizerAudioProcessorEditor::resized()
     juce::Rectangle<int> responseArea = topArea.removeFromRight(topArea.getWidth() * 0.85f);
 
 	responseCurveComponent.setBounds(responseArea);
+    telemetryOverlay.setBounds(responseArea.reduced(10).removeFromRight(260).removeFromTop(150));
+
+    juce::Rectangle<int> curveOptionsArea = topArea.reduced(10);
+    bandCurvesButton.setBounds(curveOptionsArea.removeFromTop(30));
+    phaseButton.setBounds(curveOptionsArea.removeFromTop(30));
+    telemetryButton.setBounds(curveOptionsArea.removeFromTop(30));
+    linearPhaseButton.setBounds(curveOptionsArea.removeFromTop(30));
+    oversamplingBox.setBounds(curveOptionsArea.removeFromTop(30).reduced(0, 3));
+    stereoModeBox.setBounds(curveOptionsArea.removeFromTop(30).reduced(0, 3));
+    presetBox.setBounds(curveOptionsArea.removeFromTop(30).reduced(0, 3));
+
+    juce::Rectangle<int> morphArea = curveOptionsArea.removeFromTop(30);
+    storeAButton.setBounds(morphArea.removeFromLeft(30).reduced(2));
+    storeBButton.setBounds(morphArea.removeFromRight(30).reduced(2));
+    morphSlider.setBounds(morphArea);
 
     juce::Rectangle<int> middleArea = bounds.removeFromTop(bounds.getHeight() * 0.5f);
     juce::Rectangle<int> bottomArea = bounds;
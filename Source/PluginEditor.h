@@ -10,6 +10,7 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "ResponseCurveCache.h"
 
 class CustomRotarySlider : public juce::Slider {
     public:
@@ -20,6 +21,17 @@ class CustomRotarySlider : public juce::Slider {
 
 struct ResponseCurveComponent : juce::Component, juce::AudioProcessorParameter::Listener, juce::Timer
 {
+    // The timer runs fast while the curves or spectra are moving, slows
+    // down once they have been still for a while, and stops, along with the
+    // analyzer, while the component isn't on screen. A parameter change is
+    // picked up by the next tick, which puts the timer back at full rate.
+    static constexpr int activeRateHz = 60;
+    static constexpr int idleRateHz = 5;
+    static constexpr int framesBeforeIdle = 30;
+
+    // Points closer than this to the line through their neighbours are dropped.
+    static constexpr float decimationTolerance = 0.3f;
+
     ResponseCurveComponent(EqualizerAudioProcessor& p);
     ~ResponseCurveComponent();
 
@@ -28,11 +40,75 @@ struct ResponseCurveComponent : juce::Component, juce::AudioProcessorParameter::
 
     void timerCallback() override;
 	void paint(juce::Graphics& g) override;
+    void resized() override;
+    void visibilityChanged() override;
+
+    void setShowBandCurves(bool shouldShow);
+    void setShowPhase(bool shouldShow);
+
+    // Restarts the timer at full rate if the component is showing.
+    void wake();
 
 	EqualizerAudioProcessor& audioProcessor;
-	juce::Atomic<bool> parametersChanged;
+	juce::Atomic<bool> parametersChanged{ true };
+
+    ResponseCurveCache curveCache;
+    juce::SharedResourcePointer<CoefficientCache> coefficientCache;
+    bool showBandCurves{ false };
+    bool showPhase{ false };
+
+    // One level per pixel column, already decimated by the analyzer thread.
+    int lastAnalyzerFrame{ 0 };
+    std::vector<float> preSpectrum, prePeaks, postSpectrum, postPeaks;
+    std::vector<float> newPreSpectrum, newPrePeaks, newPostSpectrum, newPostPeaks;
+
+private:
+    // Told when the component or any window it sits in is shown or hidden.
+    struct ShowingWatcher : juce::ComponentMovementWatcher {
+        explicit ShowingWatcher(ResponseCurveComponent& c) : juce::ComponentMovementWatcher(&c), owner(c) {}
+
+        void componentMovedOrResized(bool, bool) override {}
+        void componentPeerChanged() override { owner.wake(); }
+        void componentVisibilityChanged() override { owner.wake(); }
+
+        ResponseCurveComponent& owner;
+    };
+
+    void setTimerRate(bool active);
+
+    bool updateSpectra();
+    void rebuildCurvePaths();
+    void rebuildSpectrumPaths();
+    void renderBackground(float scale);
+
+    ShowingWatcher showingWatcher{ *this };
+    bool timerIsActive{ false };
+    int idleFrames{ 0 };
 
-	ChannelEQ channelEQ;
+    // Grid and fill, drawn once per size and display scale.
+    juce::Image background;
+    float backgroundScale{ 0.0f };
+
+    // Rebuilt only when their data changes; paint just strokes them.
+    juce::Path magnitudePath, phasePath;
+    std::array<juce::Path, EQCoefficients::numBands> bandPaths;
+    juce::Path preSpectrumPath, postSpectrumPath, postPeakPath;
+    juce::Rectangle<int> curveBounds, spectrumBounds;
+};
+
+// Optional readout of the processor's telemetry, drawn over the response
+// curve. Clicking it resets the counters.
+struct TelemetryOverlay : juce::Component, juce::Timer
+{
+    TelemetryOverlay(EqualizerAudioProcessor& p);
+
+    void timerCallback() override;
+    void paint(juce::Graphics& g) override;
+    void visibilityChanged() override;
+    void mouseDown(const juce::MouseEvent&) override;
+
+    EqualizerAudioProcessor& audioProcessor;
+    PerformanceTelemetry::Snapshot snapshot;
 };
 
 //==============================================================================
@@ -77,5 +153,25 @@ private:
 
 	ResponseCurveComponent responseCurveComponent;
 
+    juce::ToggleButton bandCurvesButton{ "Bands" };
+    juce::ToggleButton phaseButton{ "Phase" };
+    juce::ToggleButton telemetryButton{ "Stats" };
+    TelemetryOverlay telemetryOverlay;
+
+    juce::ToggleButton linearPhaseButton{ "Linear Phase" };
+    juce::AudioProcessorValueTreeState::ButtonAttachment linearPhaseButtonAttachment;
+
+    juce::ComboBox oversamplingBox;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> oversamplingBoxAttachment;
+
+    juce::ComboBox stereoModeBox;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> stereoModeBoxAttachment;
+
+    // Programs, and the A/B morph between two stored snapshots.
+    juce::ComboBox presetBox;
+    juce::TextButton storeAButton{ "A" };
+    juce::TextButton storeBButton{ "B" };
+    juce::Slider morphSlider{ juce::Slider::LinearHorizontal, juce::Slider::NoTextBox };
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EqualizerAudioProcessorEditor)
 };
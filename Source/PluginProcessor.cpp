@@ -9,39 +9,6 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
-ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts) {
-    ChainSettings settings;
-
-    if (std::atomic<float>* param = apvts.getRawParameterValue("Peak1Freq"))
-        settings.peak1Frequency = param->load();
-    if (std::atomic<float>* param = apvts.getRawParameterValue("Peak1Gain"))
-        settings.peak1GainInDecibels = param->load();
-    if (std::atomic<float>* param = apvts.getRawParameterValue("Peak1Q"))
-        settings.peak1Quality = param->load();
-    if (std::atomic<float>* param = apvts.getRawParameterValue("Peak2Freq"))
-        settings.peak2Frequency = param->load();
-    if (std::atomic<float>* param = apvts.getRawParameterValue("Peak2Gain"))
-        settings.peak2GainInDecibels = param->load();
-    if (std::atomic<float>* param = apvts.getRawParameterValue("Peak2Q"))
-        settings.peak2Quality = param->load();
-
-    if (std::atomic<float>* param = apvts.getRawParameterValue("LowCutFreq"))
-        settings.lowCutFrequency = param->load();
-    if (std::atomic<float>* param = apvts.getRawParameterValue("LowCutSlope"))
-        settings.lowCutSlope = static_cast<Slope>(param->load());
-    if (std::atomic<float>* param = apvts.getRawParameterValue("HighCutFreq"))
-        settings.highCutFrequency = param->load();
-    if (std::atomic<float>* param = apvts.getRawParameterValue("HighCutSlope"))
-        settings.highCutSlope = static_cast<Slope>(param->load());
-
-    if (std::atomic<float>* param = apvts.getRawParameterValue("OutputGain"))
-        settings.outputGain = param->load();
-    if (std::atomic<float>* param = apvts.getRawParameterValue("Bypass"))
-        settings.bypass = static_cast<bool>(param->load());
-
-    return settings;
-}
-
 //==============================================================================
 EqualizerAudioProcessor::EqualizerAudioProcessor()
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -49,18 +16,31 @@ EqualizerAudioProcessor::EqualizerAudioProcessor()
                      #if ! JucePlugin_IsMidiEffect
                       #if ! JucePlugin_IsSynth
                        .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                       .withInput  ("Sidechain", juce::AudioChannelSet::stereo(), false)
                       #endif
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
                      #endif
                        )
 #endif
     , apvts(*this, nullptr, "Parameters", createParameterLayout())
+    , coefficientPipeline(apvts)
+    , presetBank(apvts)
 {
+    coefficientPipeline.setListener(&linearPhase);
+    bypassParameter = apvts.getRawParameterValue("Bypass");
+
+    setParallelWorkers(juce::SystemStats::getEnvironmentVariable("EQUALIZER_WORKERS", {}).getIntValue());
 
+    const juce::String telemetryLogPath = juce::SystemStats::getEnvironmentVariable("EQUALIZER_TELEMETRY_LOG", {});
+    if (juce::File::isAbsolutePath(telemetryLogPath))
+        startTelemetryLog(juce::File(telemetryLogPath), 1000);
 }
 
 EqualizerAudioProcessor::~EqualizerAudioProcessor()
 {
+    stopTelemetryLog();
+    cancelPendingUpdate();
+    coefficientPipeline.setListener(nullptr);
 }
 
 //==============================================================================
@@ -98,31 +78,57 @@ bool EqualizerAudioProcessor::isMidiEffect() const
 
 double EqualizerAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    return tailLengthSeconds.load(std::memory_order_relaxed);
 }
 
 int EqualizerAudioProcessor::getNumPrograms()
 {
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-                // so this should be at least 1, even if you're not really implementing programs.
+    return presetBank.getNumPresets();
 }
 
 int EqualizerAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return presetBank.getCurrentIndex();
 }
 
 void EqualizerAudioProcessor::setCurrentProgram (int index)
 {
+    if (!juce::isPositiveAndBelow(index, presetBank.getNumPresets()))
+        return;
+
+    // The audio thread switches to the preset's precomputed coefficients on
+    // its next block. The parameters are written under the pipeline's lock,
+    // so it never designs half a preset and can't publish the old settings
+    // after the switch.
+    const juce::ScopedLock sl(coefficientPipeline.getParameterLock());
+    applyParameters(apvts, presetBank.getPreset(index).parameters);
+    presetBank.select(index);
 }
 
 const juce::String EqualizerAudioProcessor::getProgramName (int index)
 {
-    return {};
+    return juce::isPositiveAndBelow(index, presetBank.getNumPresets()) ? presetBank.getPreset(index).name : juce::String();
 }
 
 void EqualizerAudioProcessor::changeProgramName (int index, const juce::String& newName)
 {
+    // Factory presets keep their names.
+}
+
+void EqualizerAudioProcessor::storeMorphSnapshot(int slot)
+{
+    morphSnapshots[slot == 0 ? 0 : 1] = captureParameters(apvts);
+}
+
+void EqualizerAudioProcessor::setMorphPosition(float position)
+{
+    morphPosition = juce::jlimit(0.0f, 1.0f, position);
+
+    if (!hasMorphSnapshots())
+        return;
+
+    const juce::ScopedLock sl(coefficientPipeline.getParameterLock());
+    morphParameters(apvts, morphSnapshots[0], morphSnapshots[1], morphPosition);
 }
 
 //==============================================================================
@@ -131,21 +137,60 @@ void EqualizerAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBl
     // Use this method as the place to do any pre-playback
     // initialisation that you need..
 
-    juce::dsp::ProcessSpec spec;
-    spec.maximumBlockSize = samplesPerBlock;
-    spec.numChannels = 1;
-    spec.sampleRate = sampleRate;
+    // A worker beyond one per extra group would never get anything to do.
+    const int numGroups = (getTotalNumOutputChannels() + EQEngine::laneWidth - 1) / EQEngine::laneWidth;
+    const int numWorkers = juce::jmin(parallelWorkers, numGroups - 1);
+
+    engine.setWorkerPool(nullptr);
+    workerPool.reset();
+
+    if (numWorkers > 0)
+        workerPool = std::make_unique<RealtimeWorkerPool>(numWorkers, sampleRate, samplesPerBlock);
+
+    engine.setWorkerPool(workerPool.get());
+    engine.prepare(sampleRate, samplesPerBlock, getTotalNumOutputChannels());
+    linearPhase.prepare(sampleRate, samplesPerBlock, getTotalNumOutputChannels());
+    dynamics.prepare(sampleRate, samplesPerBlock, juce::jmax(getMainBusNumInputChannels(), getChannelCountOfBus(true, 1)));
+
+    telemetry.prepare(sampleRate);
+    smoothedSettings.prepare(sampleRate);
+    coefficientPipeline.prepare(sampleRate);
+    presetBank.prepare(sampleRate, coefficientCache);
+    analyzer.prepare(sampleRate);
+
+    if (const EQCoefficients* coefficients = coefficientPipeline.acquire()) {
+        targetCoefficients = coefficients;
+        smoothedCoefficients = *coefficients;
+        smoothedSettings.setCurrentAndTarget(coefficients->settings);
+        engine.setOversamplingOrder(coefficients->settings.oversamplingOrder);
+        oversamplingOrder.store(coefficients->settings.oversamplingOrder);
+        engine.setCoefficients(*coefficients);
+        dynamics.setSettings(coefficients->settings, coefficients->sampleRate);
+        linearPhaseActive.store(coefficients->settings.linearPhase);
+        updateTailLength(*coefficients);
+    }
+
+    silentSamples = 0;
+    sleeping = false;
 
-    leftEQ.prepare(spec);
-    rightEQ.prepare(spec);
+    // The dry path has to be able to match the longest latency either mode reports.
+    bypassFader.prepare(sampleRate, samplesPerBlock, getTotalNumOutputChannels(),
+        juce::jmax(linearPhase.getLatencySamples(), EQEngine::getOversamplingLatency(EQEngine::maxOversamplingOrder)));
+    bypassFader.setBypassed(bypassParameter->load() >= 0.5f);
+    bypassFader.reset();
 
-    updateFilters();
+    setLatencySamples(getActiveLatencySamples());
 }
 
 void EqualizerAudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
+    coefficientPipeline.release();
+
+    // The workers sleep rather than spin once blocks stop, but needn't exist.
+    engine.setWorkerPool(nullptr);
+    workerPool.reset();
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -155,12 +200,12 @@ bool EqualizerAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts
     juce::ignoreUnused (layouts);
     return true;
   #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Any layout works, from mono up to immersive beds and object buses:
+    // the engine filters every channel with the same settings, except that
+    // a stereo bus can place bands on one channel, or on mid or side. The
+    // sidechain only feeds the dynamic bands' detectors, so it can have any
+    // layout too.
+    if (layouts.getMainOutputChannelSet().isDisabled())
         return false;
 
     // This checks if the input layout matches the output layout
@@ -177,8 +222,9 @@ bool EqualizerAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts
 void EqualizerAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     const juce::ScopedNoDenormals noDenormals;
-    const int totalNumInputChannels = getTotalNumInputChannels();
-    const int totalNumOutputChannels = getTotalNumOutputChannels();
+    const juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+    const int totalNumInputChannels = getMainBusNumInputChannels();
+    const int totalNumOutputChannels = getMainBusNumOutputChannels();
 
     // In case we have more outputs than inputs, this code clears any output
     // channels that didn't contain input data, (because these aren't
@@ -190,16 +236,173 @@ void EqualizerAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
         buffer.clear(channel, 0, buffer.getNumSamples());
 
     updateFilters();
+    const juce::int64 updatedTicks = juce::Time::getHighResolutionTicks();
+
+    const int numChannels = juce::jmin(totalNumInputChannels, buffer.getNumChannels(), engine.getNumChannels());
+    if (numChannels <= 0)
+        return;
+
+    const juce::dsp::AudioBlock<float> block = juce::dsp::AudioBlock<float>(buffer).getSubsetChannelBlock(0, static_cast<size_t>(numChannels));
+
+    const bool analyzing = analyzer.isEnabled();
+    if (analyzing)
+        analyzer.pushSamples(SpectrumAnalyzer::Pre, block);
+
+    // Silent in, and every filter has rung out: silent out, without running anything.
+    if (updateSleepState(block)) {
+        block.clear();
+        numSkippedBlocks.fetch_add(1, std::memory_order_relaxed);
+    }
+    else {
+        processWithBypass(buffer, block);
+    }
+
+    if (analyzing)
+        analyzer.pushSamples(SpectrumAnalyzer::Post, block);
+
+    telemetry.recordBlock(buffer.getNumSamples(), startTicks, updatedTicks, juce::Time::getHighResolutionTicks());
+}
+
+void EqualizerAudioProcessor::processWithBypass(const juce::AudioBuffer<float>& buffer, const juce::dsp::AudioBlock<float>& block) {
+    const bool wasBypassed = bypassFader.isBypassed();
+    bypassFader.setBypassed(bypassParameter->load(std::memory_order_relaxed) >= 0.5f);
+    bypassFader.setLatency(getActiveLatencySamples());
+    bypassFader.pushInput(block);
+
+    if (bypassFader.isBypassed()) {
+        bypassFader.processBypassed(block);
+        return;
+    }
+
+    // Filter state went stale while bypassed; start from silence under the fade-in.
+    if (wasBypassed) {
+        engine.reset();
+        linearPhase.reset();
+        dynamics.reset();
+    }
+
+    // The FIR can't follow the detectors, so dynamic bands stay static here.
+    if (linearPhaseActive.load(std::memory_order_relaxed))
+        linearPhase.process(block);
+    else if (smoothedSettings.isSmoothing() || dynamics.isActive())
+        processSubBlocks(block, getDynamicsKey(buffer, block));
+    else
+        engine.process(block);
+
+    if (bypassFader.isFading())
+        bypassFader.mix(block);
+}
+
+static bool isSilent(const juce::dsp::AudioBlock<float>& block) noexcept {
+    for (size_t channel = 0; channel < block.getNumChannels(); ++channel) {
+        const juce::Range<float> range = juce::FloatVectorOperations::findMinAndMax(block.getChannelPointer(channel), static_cast<int>(block.getNumSamples()));
+
+        if (range.getStart() < -EqualizerAudioProcessor::silenceThreshold || range.getEnd() > EqualizerAudioProcessor::silenceThreshold)
+            return false;
+    }
+
+    return true;
+}
+
+bool EqualizerAudioProcessor::updateSleepState(const juce::dsp::AudioBlock<float>& block) noexcept {
+    if (bypassFader.isFading() || !isSilent(block)) {
+        silentSamples = 0;
+        sleeping = false;
+        return false;
+    }
+
+    silentSamples += static_cast<juce::int64>(block.getNumSamples());
+    if (silentSamples <= tailLengthSamples)
+        return false;
+
+    // Everything has decayed by the tail's 120 dB, so clearing the state is
+    // inaudible and the next non-silent block starts from a clean slate.
+    if (!sleeping) {
+        sleeping = true;
+        engine.reset();
+        linearPhase.reset();
+        dynamics.reset();
+    }
+
+    // Nobody can hear a ramp, so one that is pending lands straight away.
+    if (smoothedSettings.isSmoothing() && targetCoefficients != nullptr) {
+        smoothedSettings.setCurrentAndTarget(targetCoefficients->settings);
+        smoothedCoefficients = *targetCoefficients;
+        engine.setCoefficients(*targetCoefficients);
+        dynamics.setSettings(targetCoefficients->settings, targetCoefficients->sampleRate);
+    }
 
-    const juce::dsp::AudioBlock<float> audioBlock(buffer);
-    juce::dsp::AudioBlock<float> leftChannelBlock = audioBlock.getSingleChannelBlock(0);
-    juce::dsp::AudioBlock<float> rightChannelBlock = audioBlock.getSingleChannelBlock(1);
+    return true;
+}
+
+void EqualizerAudioProcessor::updateTailLength(const EQCoefficients& coefficients) {
+    const int order = coefficients.settings.oversamplingOrder;
+    const double baseSampleRate = coefficients.sampleRate / (1 << order);
+    double seconds = 0.0;
+
+    if (baseSampleRate <= 0.0)
+        return;
+
+    // The FIR paths ring for as long as their kernels; the IIR cascade until its slowest pole has decayed.
+    if (coefficients.settings.linearPhase)
+        seconds = (LinearPhaseEngine::getKernelLength(baseSampleRate) + LinearPhaseEngine::partitionSize) / baseSampleRate;
+    else
+        seconds = getTailLengthSamples(coefficients) / coefficients.sampleRate + 2.0 * EQEngine::getOversamplingLatency(order) / baseSampleRate;
+
+    tailLengthSeconds.store(seconds, std::memory_order_relaxed);
+    tailLengthSamples = std::isfinite(seconds) ? static_cast<juce::int64>(std::ceil(seconds * baseSampleRate))
+                                               : std::numeric_limits<juce::int64>::max();
+}
+
+juce::dsp::AudioBlock<const float> EqualizerAudioProcessor::getDynamicsKey(const juce::AudioBuffer<float>& buffer, const juce::dsp::AudioBlock<float>& block) {
+    if (smoothedSettings.getCurrent().dynamicsFromSidechain && getBusCount(true) > 1 && getChannelCountOfBus(true, 1) > 0) {
+        // A bus's channels are contiguous in the process buffer, so the key is a view, not a copy.
+        const int firstChannel = getChannelIndexInProcessBlockBuffer(true, 1, 0);
+        const int numChannels = juce::jmin(getChannelCountOfBus(true, 1), buffer.getNumChannels() - firstChannel);
+
+        if (numChannels > 0)
+            return juce::dsp::AudioBlock<const float>(buffer.getArrayOfReadPointers() + firstChannel, static_cast<size_t>(numChannels),
+                                                      block.getNumSamples());
+    }
+
+    // Keyed from the band's own input: each sub-block is analysed before it is filtered.
+    return block;
+}
 
-    juce::dsp::ProcessContextReplacing<float> leftChannelContext(leftChannelBlock);
-    juce::dsp::ProcessContextReplacing<float> rightChannelContext(rightChannelBlock);
+void EqualizerAudioProcessor::processSubBlocks(const juce::dsp::AudioBlock<float>& block, const juce::dsp::AudioBlock<const float>& key) {
+    const int numSamples = static_cast<int>(block.getNumSamples());
+    const double sampleRate = smoothedCoefficients.sampleRate;     // includes any oversampling
+    const bool wasSmoothing = smoothedSettings.isSmoothing();
+    constexpr int peakBands = (1 << ChainPositions::PeakBand1) | (1 << ChainPositions::PeakBand2);
+
+    for (int start = 0; start < numSamples; start += SmoothedChainSettings::subBlockSize) {
+        const int length = juce::jmin(SmoothedChainSettings::subBlockSize, numSamples - start);
+
+        if (const int bands = smoothedSettings.advance(length)) {
+            updateEQCoefficients(smoothedCoefficients, smoothedSettings.getCurrent(), sampleRate, bands, coefficientCache);
+            engine.setCoefficients(smoothedCoefficients);
+            numSmoothingUpdates.fetch_add(1, std::memory_order_relaxed);
+
+            if (bands & peakBands)
+                dynamics.setSettings(smoothedSettings.getCurrent(), sampleRate);
+        }
+        else {
+            engine.setOutputGain(juce::Decibels::decibelsToGain(smoothedSettings.getCurrent().outputGain));
+        }
+
+        const juce::dsp::AudioBlock<float> subBlock = block.getSubBlock(static_cast<size_t>(start), static_cast<size_t>(length));
+
+        if (dynamics.isActive())
+            dynamics.processSubBlock(engine, smoothedSettings.getCurrent(), subBlock, key.getSubBlock(static_cast<size_t>(start), static_cast<size_t>(length)));
+        else
+            engine.process(subBlock);
+    }
 
-    leftEQ.process(leftChannelContext);
-    rightEQ.process(rightChannelContext);
+    // Land exactly on the pipeline's design once the ramp has finished.
+    if (wasSmoothing && !smoothedSettings.isSmoothing() && targetCoefficients != nullptr) {
+        smoothedCoefficients = *targetCoefficients;
+        engine.setCoefficients(*targetCoefficients);
+    }
 }
 
 //==============================================================================
@@ -217,24 +420,32 @@ juce::AudioProcessorEditor* EqualizerAudioProcessor::createEditor()
 //==============================================================================
 void EqualizerAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
-
-    juce::MemoryOutputStream mos(destData, true);
-    apvts.state.writeToStream(mos);
+    PluginState state;
+    state.parameters = captureParameters(apvts);
+    state.program = presetBank.getCurrentIndex();
+    state.morphA = morphSnapshots[0];
+    state.morphB = morphSnapshots[1];
+    state.morphPosition = morphPosition;
+
+    writePluginState(state, destData);
 }
 
 void EqualizerAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
-
-    juce::ValueTree tree = juce::ValueTree::readFromData(data, sizeInBytes);
-    if (tree.isValid()) {
-        apvts.replaceState(tree);
-        updateFilters();
+    // Also reads the ValueTree states older versions saved.
+    PluginState state;
+    if (!readPluginState(data, sizeInBytes, state))
+        return;
+
+    {
+        const juce::ScopedLock sl(coefficientPipeline.getParameterLock());
+        applyParameters(apvts, state.parameters);
     }
+
+    presetBank.setCurrentIndex(state.program);
+    morphSnapshots = { state.morphA, state.morphB };
+    morphPosition = state.morphPosition;
+    coefficientPipeline.requestUpdate();
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout EqualizerAudioProcessor::createParameterLayout() {
@@ -326,87 +537,222 @@ juce::AudioProcessorValueTreeState::ParameterLayout EqualizerAudioProcessor::cre
     ));
 
     layout.add(std::make_unique<juce::AudioParameterChoice>(
-        "FilterType", "Filter Type",
+        "FilterType", "Peak 1 Type",
+        juce::StringArray({ "Low Shelf", "High Shelf", "Bell", "Notch" }), 2
+    ));
+
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        "Peak2Type", "Peak 2 Type",
         juce::StringArray({ "Low Shelf", "High Shelf", "Bell", "Notch" }), 2
     ));
 
+    // Processing modes, appended so existing parameter indices don't move.
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        "LinearPhase", "Linear Phase", false
+    ));
+
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        "Oversampling", "Oversampling",
+        juce::StringArray({ "Off", "2x", "4x", "8x" }), 0
+    ));
+
+    // Dynamic peak bands, appended so existing parameter indices don't move.
+    for (const int band : { 1, 2 }) {
+        const juce::String id = "Peak" + juce::String(band);
+        const juce::String name = "Peak " + juce::String(band);
+
+        layout.add(std::make_unique<juce::AudioParameterBool>(
+            id + "Dynamic", name + " Dynamic (IIR only)", false
+        ));
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>(
+            id + "Threshold", name + " Threshold",
+            juce::NormalisableRange<float>(-60.0f, 0.0f, 0.1f, 1.0f), -24.0f,
+            "dB",
+            juce::AudioProcessorParameter::genericParameter,
+            [](float value, int) { return juce::String(value, 1) + " dB"; }
+        ));
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>(
+            id + "Ratio", name + " Ratio",
+            juce::NormalisableRange<float>(1.0f, 20.0f, 0.1f, 0.5f), 2.0f,
+            "",
+            juce::AudioProcessorParameter::genericParameter,
+            [](float value, int) { return juce::String(value, 1) + ":1"; }
+        ));
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>(
+            id + "Attack", name + " Attack",
+            juce::NormalisableRange<float>(0.1f, 200.0f, 0.1f, 0.4f), 10.0f,
+            "ms",
+            juce::AudioProcessorParameter::genericParameter,
+            [](float value, int) { return juce::String(value, 1) + " ms"; }
+        ));
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>(
+            id + "Release", name + " Release",
+            juce::NormalisableRange<float>(5.0f, 2000.0f, 1.0f, 0.4f), 100.0f,
+            "ms",
+            juce::AudioProcessorParameter::genericParameter,
+            [](float value, int) { return juce::String(value, 0) + " ms"; }
+        ));
+    }
+
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        "DynamicKey", "Dynamic Key (IIR only)",
+        juce::StringArray({ "Band Input", "Sidechain" }), 0
+    ));
+
+    // Extra bands, off by default and spread log-evenly over the audio range.
+    for (int position = ChainPositions::FirstExtraBand; position < maxBands; ++position) {
+        const juce::String name = "Band " + juce::String(position + 1);
+        const int index = position - ChainPositions::FirstExtraBand;
+        const float defaultFrequency = 20.0f * std::pow(1000.0f, (static_cast<float>(index) + 0.5f) / static_cast<float>(numExtraBands));
+
+        layout.add(std::make_unique<juce::AudioParameterBool>(
+            getBandParameterID(position, "On"), name + " On", false
+        ));
+
+        layout.add(std::make_unique<juce::AudioParameterChoice>(
+            getBandParameterID(position, "Type"), name + " Type",
+            juce::StringArray({ "Low Shelf", "High Shelf", "Bell", "Notch" }), 2
+        ));
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>(
+            getBandParameterID(position, "Freq"), name + " Frequency",
+            juce::NormalisableRange<float>(20.0f, 20000.0f, 0.1f, 0.25f), defaultFrequency,
+            "Hz",
+            juce::AudioProcessorParameter::genericParameter,
+            [](float value, int) { return juce::String(value, 1) + " Hz"; }
+        ));
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>(
+            getBandParameterID(position, "Gain"), name + " Gain",
+            juce::NormalisableRange<float>(-24.0f, 24.0f, 0.1f, 1.0f), 0.0f,
+            "dB",
+            juce::AudioProcessorParameter::genericParameter,
+            [](float value, int) { return juce::String(value, 1) + " dB"; }
+        ));
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>(
+            getBandParameterID(position, "Q"), name + " Quality",
+            juce::NormalisableRange<float>(0.1f, 10.0f, 0.05f, 0.5f), 0.71f
+        ));
+    }
+
+    // Stereo placement, appended so existing parameter indices don't move.
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        "StereoMode", "Stereo Mode",
+        juce::StringArray({ "Left / Right", "Mid / Side" }), 0
+    ));
+
+    for (int position = 0; position < maxBands; ++position) {
+        static const juce::StringArray fixedBandNames{ "Low Cut", "Peak 1", "Peak 2", "High Cut" };
+        const juce::String name = position < ChainPositions::FirstExtraBand ? fixedBandNames[position] : "Band " + juce::String(position + 1);
+
+        layout.add(std::make_unique<juce::AudioParameterChoice>(
+            getPlacementParameterID(position), name + " Channels",
+            juce::StringArray({ "Both", "Left / Mid", "Right / Side" }), 0
+        ));
+    }
+
     return layout;
 }
 
 void EqualizerAudioProcessor::updateFilters() {
-    const ChainSettings chainSettings = getChainSettings(apvts);
-
-    updatePeakFilters(chainSettings);
-    updateCutFilters(chainSettings);
+    // Coefficients are designed by the pipeline's background thread; here we
+    // only pick up a newly published set, if any.
+    if (const EQCoefficients* coefficients = coefficientPipeline.acquire())
+        adoptCoefficients(*coefficients);
+
+    // A preset switch goes straight to the preset's precomputed set; the
+    // pipeline catches up once it has seen the new parameters. Linear-phase
+    // mode needs new kernels, so it waits for the pipeline instead.
+    if (const EQCoefficients* preset = presetBank.acquire(engine.getOversamplingOrder()))
+        if (!linearPhaseActive.load(std::memory_order_relaxed))
+            adoptCoefficients(*preset);
 }
 
-std::pair<juce::ReferenceCountedObjectPtr<juce::dsp::IIR::Coefficients<float>>,
-          juce::ReferenceCountedObjectPtr<juce::dsp::IIR::Coefficients<float>>>
-    makePeakFilters(const ChainSettings& chainSettings, double sampleRate) {
+void EqualizerAudioProcessor::adoptCoefficients(const EQCoefficients& coefficients) {
+    targetCoefficients = &coefficients;
+    updateTailLength(coefficients);
 
-    juce::ReferenceCountedObjectPtr<juce::dsp::IIR::Coefficients<float>> peak1Coefficients = juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, chainSettings.peak1Frequency,
-        chainSettings.peak1Quality, juce::Decibels::decibelsToGain(chainSettings.peak1GainInDecibels));
+    const bool rateChanged = coefficients.settings.oversamplingOrder != engine.getOversamplingOrder();
+    if (rateChanged) {
+        engine.setOversamplingOrder(coefficients.settings.oversamplingOrder);
+        oversamplingOrder.store(coefficients.settings.oversamplingOrder, std::memory_order_relaxed);
+        triggerAsyncUpdate();
+    }
 
-    juce::ReferenceCountedObjectPtr<juce::dsp::IIR::Coefficients<float>> peak2Coefficients = juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, chainSettings.peak2Frequency,
-        chainSettings.peak2Quality, juce::Decibels::decibelsToGain(chainSettings.peak2GainInDecibels));
+    // Convolution crossfades between kernels itself, so there is nothing
+    // to ramp while the linear-phase path is running; after a rate change
+    // the old and new designs can't be interpolated either.
+    if (coefficients.settings.linearPhase || rateChanged)
+        smoothedSettings.setCurrentAndTarget(coefficients.settings);
+    else
+        smoothedSettings.setTarget(coefficients.settings);
+
+    if (!smoothedSettings.isSmoothing()) {
+        smoothedCoefficients = coefficients;
+        engine.setCoefficients(coefficients);
+    }
 
-	return { peak1Coefficients, peak2Coefficients };
-}
+    dynamics.setSettings(smoothedSettings.getCurrent(), coefficients.sampleRate);
 
-void EqualizerAudioProcessor::updatePeakFilters(const ChainSettings& chainSettings) {
-    auto [peak1Coefficients, peak2Coefficients] = makePeakFilters(chainSettings, getSampleRate());
+    // A band that just stopped being dynamic goes back to its static design.
+    for (int band = 0; band < DynamicEQ::numDynamicBands; ++band)
+        if (!dynamics.isBandActive(band))
+            engine.setBandSection(DynamicEQ::getChainPosition(band), 0, smoothedCoefficients.bands[DynamicEQ::getChainPosition(band)].sections[0]);
 
-    *leftEQ.get<ChainPositions::PeakBand1>().coefficients = *peak1Coefficients;
-    *rightEQ.get<ChainPositions::PeakBand1>().coefficients = *peak1Coefficients;
+    if (coefficients.settings.linearPhase != linearPhaseActive.load(std::memory_order_relaxed)) {
+        linearPhaseActive.store(coefficients.settings.linearPhase, std::memory_order_relaxed);
 
-    *leftEQ.get<ChainPositions::PeakBand2>().coefficients = *peak2Coefficients;
-    *rightEQ.get<ChainPositions::PeakBand2>().coefficients = *peak2Coefficients;
+        // Don't let the path we're leaving ring out when it's switched back on.
+        engine.reset();
+        linearPhase.reset();
+        triggerAsyncUpdate();
+    }
 }
 
-void EqualizerAudioProcessor::updateCutFilters(const ChainSettings& chainSettings) {
-    const double sampleRate = getSampleRate();
+int EqualizerAudioProcessor::getActiveLatencySamples() const {
+    if (linearPhaseActive.load())
+        return linearPhase.getLatencySamples();
 
-	const juce::ReferenceCountedArray<juce::dsp::IIR::Coefficients<float>> lowCutCoefficients = makeLowCutFilter(chainSettings, sampleRate);
-    resetCutFilterBypass(leftEQ.get<ChainPositions::LowCut>());
-    resetCutFilterBypass(rightEQ.get<ChainPositions::LowCut>());
-    applyCutFilterCoefficients(leftEQ.get<ChainPositions::LowCut>(), lowCutCoefficients, chainSettings.lowCutSlope);
-    applyCutFilterCoefficients(rightEQ.get<ChainPositions::LowCut>(), lowCutCoefficients, chainSettings.lowCutSlope);
+    return EQEngine::getOversamplingLatency(oversamplingOrder.load());
+}
 
-    const juce::ReferenceCountedArray<juce::dsp::IIR::Coefficients<float>> highCutCoefficients = makeHighCutFilter(chainSettings, sampleRate);
-    resetCutFilterBypass(leftEQ.get<ChainPositions::HighCut>());
-    resetCutFilterBypass(rightEQ.get<ChainPositions::HighCut>());
-    applyCutFilterCoefficients(leftEQ.get<ChainPositions::HighCut>(), highCutCoefficients, chainSettings.highCutSlope);
-    applyCutFilterCoefficients(rightEQ.get<ChainPositions::HighCut>(), highCutCoefficients, chainSettings.highCutSlope);
+void EqualizerAudioProcessor::handleAsyncUpdate() {
+    setLatencySamples(getActiveLatencySamples());
 }
 
-void EqualizerAudioProcessor::resetCutFilterBypass(BandFilter& filterChain) {
-    filterChain.template setBypassed<0>(true);
-    filterChain.template setBypassed<1>(true);
-    filterChain.template setBypassed<2>(true);
-    filterChain.template setBypassed<3>(true);
+void EqualizerAudioProcessor::startTelemetryLog(const juce::File& logFile, int intervalMs) {
+    stopTelemetryLog();
+    telemetryLog = std::make_unique<TelemetryLog>(telemetry, logFile, intervalMs, [this] { return describeSettings(); });
 }
 
-void applyCutFilterCoefficients(BandFilter& filterChain, const juce::ReferenceCountedArray<juce::dsp::IIR::Coefficients<float>>& coefficients, Slope slope) {
-    switch (slope) {
-        case Slope_48dB:
-            updateCutFilterStage<3>(filterChain, coefficients[3]);
-        case Slope_36dB:
-            updateCutFilterStage<2>(filterChain, coefficients[2]);
-        case Slope_24dB:
-            updateCutFilterStage<1>(filterChain, coefficients[1]);
-        case Slope_12dB:
-            updateCutFilterStage<0>(filterChain, coefficients[0]);
-            break;
-        default:
-            jassertfalse; // Invalid slope value
-            break;
-    }
+void EqualizerAudioProcessor::stopTelemetryLog() {
+    telemetryLog.reset();
 }
 
-template <int Stage>
-void updateCutFilterStage(BandFilter& filterChain, const typename IIRFilter::CoefficientsPtr& coefficients) {
-    filterChain.template get<Stage>().coefficients = coefficients;
-    filterChain.template setBypassed<Stage>(false);
+// Called from the telemetry log's thread; only reads atomics.
+juce::String EqualizerAudioProcessor::describeSettings() {
+    const ChainSettings settings = getChainSettings(apvts);
+
+    int extraBands = 0;
+    for (const BandSettings& band : settings.extraBands)
+        if (band.enabled)
+            ++extraBands;
+
+    const int dynamicBands = (settings.peak1Dynamics.enabled ? 1 : 0) + (settings.peak2Dynamics.enabled ? 1 : 0);
+
+    juce::String description;
+    description << juce::String(getSampleRate(), 0) << " Hz, " << getBlockSize() << " samples, "
+                << (settings.linearPhase ? "linear phase" : (settings.oversamplingOrder > 0 ? juce::String(1 << settings.oversamplingOrder) + "x IIR" : "IIR"))
+                << ", " << extraBands << " extra bands, " << dynamicBands << " dynamic"
+                << (settings.linearPhase && dynamicBands > 0 ? " (static in linear phase)" : "")
+                << (settings.bypass ? ", bypassed" : "")
+                << ", " << getNumSkippedBlocks() << " blocks skipped";
+    return description;
 }
 
 //==============================================================================
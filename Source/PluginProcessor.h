@@ -9,60 +9,24 @@
 #pragma once
 
 #include <JuceHeader.h>
-
-//==============================================================================
-using IIRFilter = juce::dsp::IIR::Filter<float>;
-using BandFilter = juce::dsp::ProcessorChain<IIRFilter, IIRFilter, IIRFilter, IIRFilter>;
-using ChannelEQ = juce::dsp::ProcessorChain<BandFilter, IIRFilter, IIRFilter, BandFilter>;
-
-enum ChainPositions {
-    LowCut,
-    PeakBand1,
-    PeakBand2,
-    HighCut
-};
-
-enum Slope {
-    Slope_12dB = 0,
-    Slope_24dB,
-    Slope_36dB,
-    Slope_48dB
-};
-
-struct ChainSettings {
-    float peak1Frequency{ 500 }, peak1GainInDecibels{ 0 }, peak1Quality{ 1.0f };
-    float peak2Frequency{ 2000 }, peak2GainInDecibels{ 0 }, peak2Quality{ 1.0f };
-    float lowCutFrequency{ 80 }, highCutFrequency{ 12000 };
-    Slope lowCutSlope{ Slope_12dB }, highCutSlope{ Slope_12dB };
-    float outputGain{ 0 };
-    bool bypass{ false };
-};
-
-ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts);
-
-std::pair<juce::ReferenceCountedObjectPtr<juce::dsp::IIR::Coefficients<float>>,
-    juce::ReferenceCountedObjectPtr<juce::dsp::IIR::Coefficients<float>>>
-    makePeakFilters(const ChainSettings& chainSettings, double sampleRate);
-
-void applyCutFilterCoefficients(BandFilter& filterChain, const juce::ReferenceCountedArray<juce::dsp::IIR::Coefficients<float>>& coefficients, Slope slope);
-
-template <int Stage>
-void updateCutFilterStage(BandFilter& filterChain, const typename IIRFilter::CoefficientsPtr& coefficients);
-
-inline auto makeLowCutFilter(const ChainSettings& chainSettings, double sampleRate) {
-    return juce::dsp::FilterDesign<float>::designIIRHighpassHighOrderButterworthMethod(
-        chainSettings.lowCutFrequency, sampleRate, 2 * (chainSettings.lowCutSlope + 1));
-};
-
-inline auto makeHighCutFilter(const ChainSettings& chainSettings, double sampleRate) {
-    return juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod(
-        chainSettings.highCutFrequency, sampleRate, 2 * (chainSettings.highCutSlope + 1));
-};
+#include "BypassFader.h"
+#include "ChainSettings.h"
+#include "CoefficientPipeline.h"
+#include "DynamicEQ.h"
+#include "EQEngine.h"
+#include "LinearPhaseEngine.h"
+#include "PerformanceTelemetry.h"
+#include "PluginState.h"
+#include "PresetBank.h"
+#include "RealtimeWorkerPool.h"
+#include "SmoothedChainSettings.h"
+#include "SpectrumAnalyzer.h"
 
 //==============================================================================
 /**
 */
-class EqualizerAudioProcessor  : public juce::AudioProcessor
+class EqualizerAudioProcessor  : public juce::AudioProcessor,
+                                 private juce::AsyncUpdater
 {
 public:
     //==============================================================================
@@ -102,7 +66,48 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
-    
+    // Lets hosts drive the crossfaded bypass instead of their own hard one.
+    juce::AudioProcessorParameter* getBypassParameter() const override { return apvts.getParameter("Bypass"); }
+
+    // A/B morph, message thread only. storeMorphSnapshot takes the current
+    // parameters as snapshot 0 (A) or 1 (B); setMorphPosition then moves
+    // every parameter that differs between them. The audio thread ramps to
+    // each new setting on the usual sub-block grid, so dragging the morph
+    // costs no more than automating the same parameters.
+    void storeMorphSnapshot(int slot);
+    bool hasMorphSnapshots() const noexcept { return !morphSnapshots[0].empty() && !morphSnapshots[1].empty(); }
+    void setMorphPosition(float position);
+    float getMorphPosition() const noexcept { return morphPosition; }
+
+    // Input below this (under a 24-bit LSB) counts as digital silence.
+    static constexpr float silenceThreshold = 1.0e-7f;
+
+    // Blocks that were silent in and out with every filter rung out, so
+    // nothing was processed.
+    juce::int64 getNumSkippedBlocks() const noexcept { return numSkippedBlocks.load(std::memory_order_relaxed); }
+
+    // Number of sub-block coefficient redesigns done while parameters were ramping.
+    juce::int64 getNumSmoothingUpdates() const noexcept { return numSmoothingUpdates.load(std::memory_order_relaxed); }
+
+    SpectrumAnalyzer& getAnalyzer() noexcept { return analyzer; }
+
+    // What processBlock costs; always recorded, it's a few counter updates per block.
+    PerformanceTelemetry& getTelemetry() noexcept { return telemetry; }
+
+    // Spreads the IIR engine's channel groups over this many realtime worker
+    // threads when a block holds enough work; 0 keeps all of it on the audio
+    // thread. Takes effect at the next prepareToPlay. Also set at
+    // construction from the EQUALIZER_WORKERS environment variable.
+    void setParallelWorkers(int numWorkers) noexcept { parallelWorkers = juce::jlimit(0, maxParallelWorkers, numWorkers); }
+    int getParallelWorkers() const noexcept { return parallelWorkers; }
+
+    static constexpr int maxParallelWorkers = 16;
+
+    // Appends a line of telemetry and the current settings to logFile every
+    // intervalMs from a background thread. Also started at construction when
+    // the EQUALIZER_TELEMETRY_LOG environment variable names a file.
+    void startTelemetryLog(const juce::File& logFile, int intervalMs);
+    void stopTelemetryLog();
 
     //==============================================================================
     juce::AudioProcessorValueTreeState apvts;
@@ -113,12 +118,70 @@ private:
     
     
     void updateFilters();
-    void updatePeakFilters(const ChainSettings& chainSettings);
-    void updateCutFilters(const ChainSettings& chainSettings);
-
-    void resetCutFilterBypass(BandFilter& filterChain);
-
-    ChannelEQ leftEQ, rightEQ;
+    void adoptCoefficients(const EQCoefficients& coefficients);
+    void processWithBypass(const juce::AudioBuffer<float>& buffer, const juce::dsp::AudioBlock<float>& block);
+    void processSubBlocks(const juce::dsp::AudioBlock<float>& block, const juce::dsp::AudioBlock<const float>& key);
+    juce::dsp::AudioBlock<const float> getDynamicsKey(const juce::AudioBuffer<float>& buffer, const juce::dsp::AudioBlock<float>& block);
+    void updateTailLength(const EQCoefficients& coefficients);
+    bool updateSleepState(const juce::dsp::AudioBlock<float>& block) noexcept;
+
+    // Reports the latency of whichever path is active; hosts want this on the message thread.
+    void handleAsyncUpdate() override;
+    juce::String describeSettings();
+    int getActiveLatencySamples() const;
+
+    CoefficientPipeline coefficientPipeline;
+    PresetBank presetBank;
+    std::array<ParameterValues, 2> morphSnapshots;
+    float morphPosition{ 0.0f };
+    EQEngine engine;
+
+    // Only while prepared, and only with more than one channel group to share.
+    int parallelWorkers{ 0 };
+    std::unique_ptr<RealtimeWorkerPool> workerPool;
+
+    // The pipeline provides the designed targets; while a ramp is running the
+    // audio thread redesigns the moving bands on the sub-block grid instead.
+    SmoothedChainSettings smoothedSettings;
+    const EQCoefficients* targetCoefficients{ nullptr };
+    EQCoefficients smoothedCoefficients;
+    juce::SharedResourcePointer<CoefficientCache> coefficientCache;
+    std::atomic<juce::int64> numSmoothingUpdates{ 0 };
+
+    // Dynamic peak bands: their gain is recomputed on the same sub-block grid
+    // from the main input or the sidechain bus. IIR path only.
+    DynamicEQ dynamics;
+
+    // Mirrors the engine's setting for the message thread's latency report.
+    std::atomic<int> oversamplingOrder{ 0 };
+
+    // Linear-phase mode replaces the IIR cascade with FIR convolution and
+    // designs its kernels from the pipeline's coefficient sets. Its kernels
+    // are shared by both channels, so band placement only applies to the
+    // IIR path. They are also only redesigned when the parameters change,
+    // far too slowly to follow a detector: dynamic peak bands sit at their
+    // static gain and the sidechain bus is ignored. The parameters say so.
+    LinearPhaseEngine linearPhase;
+    std::atomic<bool> linearPhaseActive{ false };
+
+    // Only fed while an editor has it enabled.
+    SpectrumAnalyzer analyzer;
+
+    // Once faded out, none of the paths above run. Follows the parameter
+    // directly, since preset designs don't carry it.
+    BypassFader bypassFader;
+    std::atomic<float>* bypassParameter{ nullptr };
+
+    // Once the input has been silent for longer than the tail, nothing runs
+    // until it isn't any more.
+    std::atomic<double> tailLengthSeconds{ 0.0 };
+    juce::int64 tailLengthSamples{ 0 };
+    juce::int64 silentSamples{ 0 };
+    bool sleeping{ false };
+    std::atomic<juce::int64> numSkippedBlocks{ 0 };
+
+    PerformanceTelemetry telemetry;
+    std::unique_ptr<TelemetryLog> telemetryLog;
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EqualizerAudioProcessor)
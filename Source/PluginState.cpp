@@ -0,0 +1,215 @@
+/*
+  ==============================================================================
+
+    PluginState.cpp
+
+  ==============================================================================
+*/
+
+#include "PluginState.h"
+
+// Layout, little-endian throughout:
+//   "EQST", int version, then chunks of { 4-char tag, int size, payload }.
+//   PARM  parameter list: compressed int count, then { string id, float value } each
+//   PROG  int current program
+//   MRPH  float position, then the A and B parameter lists
+static const juce::uint32 stateMagic = juce::ByteOrder::littleEndianInt("EQST");
+static const juce::uint32 parametersTag = juce::ByteOrder::littleEndianInt("PARM");
+static const juce::uint32 programTag = juce::ByteOrder::littleEndianInt("PROG");
+static const juce::uint32 morphTag = juce::ByteOrder::littleEndianInt("MRPH");
+
+// Far more than the plugin has; anything bigger is a corrupt count.
+constexpr int maxParameterValues = 4096;
+
+static void writeValues(juce::OutputStream& stream, const ParameterValues& values) {
+    stream.writeCompressedInt(static_cast<int>(values.size()));
+
+    for (const ParameterValue& parameter : values) {
+        stream.writeString(parameter.id);
+        stream.writeFloat(parameter.value);
+    }
+}
+
+static bool readValues(juce::InputStream& stream, ParameterValues& values) {
+    const int count = stream.readCompressedInt();
+    if (count < 0 || count > maxParameterValues)
+        return false;
+
+    values.clear();
+    values.reserve(static_cast<size_t>(count));
+
+    for (int index = 0; index < count; ++index) {
+        if (stream.isExhausted())
+            return false;
+
+        ParameterValue parameter;
+        parameter.id = stream.readString();
+        parameter.value = stream.readFloat();
+        values.push_back(parameter);
+    }
+
+    return true;
+}
+
+static void writeChunk(juce::OutputStream& stream, juce::uint32 tag, const juce::MemoryOutputStream& payload) {
+    stream.writeInt(static_cast<int>(tag));
+    stream.writeInt(static_cast<int>(payload.getDataSize()));
+    stream.write(payload.getData(), payload.getDataSize());
+}
+
+void writePluginState(const PluginState& state, juce::MemoryBlock& destData) {
+    juce::MemoryOutputStream stream(destData, false);
+    stream.writeInt(static_cast<int>(stateMagic));
+    stream.writeInt(pluginStateVersion);
+
+    {
+        juce::MemoryOutputStream payload;
+        writeValues(payload, state.parameters);
+        writeChunk(stream, parametersTag, payload);
+    }
+
+    {
+        juce::MemoryOutputStream payload;
+        payload.writeInt(state.program);
+        writeChunk(stream, programTag, payload);
+    }
+
+    if (!state.morphA.empty() || !state.morphB.empty()) {
+        juce::MemoryOutputStream payload;
+        payload.writeFloat(state.morphPosition);
+        writeValues(payload, state.morphA);
+        writeValues(payload, state.morphB);
+        writeChunk(stream, morphTag, payload);
+    }
+}
+
+static bool readLegacyState(const void* data, int sizeInBytes, PluginState& state) {
+    const juce::ValueTree tree = juce::ValueTree::readFromData(data, static_cast<size_t>(sizeInBytes));
+    if (!tree.isValid())
+        return false;
+
+    // AudioProcessorValueTreeState stores one PARAM child per parameter with
+    // its denormalised value.
+    state = {};
+    for (const juce::ValueTree& child : tree)
+        if (child.hasType("PARAM"))
+            state.parameters.push_back({ child.getProperty("id").toString(), static_cast<float>(child.getProperty("value")) });
+
+    return true;
+}
+
+bool readPluginState(const void* data, int sizeInBytes, PluginState& state) {
+    if (data == nullptr || sizeInBytes < 8)
+        return false;
+
+    juce::MemoryInputStream stream(data, static_cast<size_t>(sizeInBytes), false);
+    if (static_cast<juce::uint32>(stream.readInt()) != stateMagic)
+        return readLegacyState(data, sizeInBytes, state);
+
+    // Newer versions only ever add chunks, so there is nothing to check the version against yet.
+    stream.readInt();
+
+    PluginState result;
+    bool hasParameters = false;
+
+    while (stream.getNumBytesRemaining() >= 8) {
+        const juce::uint32 tag = static_cast<juce::uint32>(stream.readInt());
+        const int size = stream.readInt();
+
+        if (size < 0 || size > stream.getNumBytesRemaining())
+            return false;
+
+        juce::MemoryInputStream chunk(static_cast<const char*>(data) + stream.getPosition(), static_cast<size_t>(size), false);
+        stream.skipNextBytes(size);
+
+        if (tag == parametersTag) {
+            if (!readValues(chunk, result.parameters))
+                return false;
+
+            hasParameters = true;
+        }
+        else if (tag == programTag) {
+            result.program = chunk.readInt();
+        }
+        else if (tag == morphTag) {
+            result.morphPosition = juce::jlimit(0.0f, 1.0f, chunk.readFloat());
+            if (!readValues(chunk, result.morphA) || !readValues(chunk, result.morphB))
+                return false;
+        }
+    }
+
+    if (!hasParameters)
+        return false;
+
+    state = std::move(result);
+    return true;
+}
+
+//==============================================================================
+bool isModeParameter(const juce::String& parameterID) noexcept {
+    return parameterID == "Bypass" || parameterID == "LinearPhase" || parameterID == "Oversampling";
+}
+
+ParameterValues captureParameters(const juce::AudioProcessorValueTreeState& apvts) {
+    ParameterValues values;
+
+    for (juce::AudioProcessorParameter* parameter : apvts.processor.getParameters())
+        if (const juce::RangedAudioParameter* ranged = dynamic_cast<const juce::RangedAudioParameter*>(parameter))
+            values.push_back({ ranged->getParameterID(), ranged->convertFrom0to1(ranged->getValue()) });
+
+    return values;
+}
+
+static void setNormalisedValue(juce::RangedAudioParameter& parameter, float normalisedValue) {
+    // Unchanged parameters would only make the host record automation.
+    if (parameter.getValue() != normalisedValue)
+        parameter.setValueNotifyingHost(normalisedValue);
+}
+
+void applyParameters(juce::AudioProcessorValueTreeState& apvts, const ParameterValues& values) {
+    for (const ParameterValue& value : values)
+        if (juce::RangedAudioParameter* parameter = apvts.getParameter(value.id))
+            setNormalisedValue(*parameter, parameter->convertTo0to1(value.value));
+}
+
+static const ParameterValue* findValue(const ParameterValues& values, size_t hint, const juce::String& id) {
+    // Snapshots taken from the same processor are in the same order.
+    if (hint < values.size() && values[hint].id == id)
+        return &values[hint];
+
+    for (const ParameterValue& value : values)
+        if (value.id == id)
+            return &value;
+
+    return nullptr;
+}
+
+void morphParameters(juce::AudioProcessorValueTreeState& apvts, const ParameterValues& a, const ParameterValues& b, float position) {
+    position = juce::jlimit(0.0f, 1.0f, position);
+
+    for (size_t index = 0; index < a.size(); ++index) {
+        const ParameterValue& from = a[index];
+        const ParameterValue* to = findValue(b, index, from.id);
+        juce::RangedAudioParameter* parameter = apvts.getParameter(from.id);
+
+        if (to == nullptr || parameter == nullptr || isModeParameter(from.id))
+            continue;
+
+        const float start = parameter->convertTo0to1(from.value);
+        const float end = parameter->convertTo0to1(to->value);
+
+        if (parameter->isDiscrete() || parameter->isBoolean())
+            setNormalisedValue(*parameter, position < 0.5f ? start : end);
+        else
+            setNormalisedValue(*parameter, start + (end - start) * position);
+    }
+}
+
+ChainSettings getChainSettings(const ParameterValues& values) {
+    ChainSettings settings;
+
+    for (const ParameterValue& value : values)
+        setChainSettingsParameter(settings, value.id, value.value);
+
+    return settings;
+}
@@ -0,0 +1,62 @@
+/*
+  ==============================================================================
+
+    PluginState.h
+
+    Saved plugin state: a compact, versioned binary format made of tagged
+    chunks. Readers skip chunks they don't know, so newer states still load
+    in older versions, and anything that isn't binary is read as the
+    ValueTree format older versions saved. Works on plain parameter lists,
+    so offline tools can read states without a live processor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ChainSettings.h"
+
+//==============================================================================
+struct ParameterValue {
+    juce::String id;
+    float value;    // denormalised, as the parameter displays it
+};
+
+using ParameterValues = std::vector<ParameterValue>;
+
+struct PluginState {
+    ParameterValues parameters;
+    int program{ 0 };
+
+    // A/B morph snapshots; empty until stored.
+    ParameterValues morphA, morphB;
+    float morphPosition{ 0.0f };
+};
+
+constexpr int pluginStateVersion = 1;
+
+void writePluginState(const PluginState& state, juce::MemoryBlock& destData);
+
+// Returns false if the data is neither format.
+bool readPluginState(const void* data, int sizeInBytes, PluginState& state);
+
+//==============================================================================
+// Bypass and the processing-mode switches aren't part of a sound; presets
+// and the A/B morph leave them alone.
+bool isModeParameter(const juce::String& parameterID) noexcept;
+
+ParameterValues captureParameters(const juce::AudioProcessorValueTreeState& apvts);
+
+// Message thread. Sets every listed parameter that exists and notifies the
+// host; unlisted parameters keep their values.
+void applyParameters(juce::AudioProcessorValueTreeState& apvts, const ParameterValues& values);
+
+// Message thread. Moves every parameter listed in both snapshots to
+// position (0 = a, 1 = b) between them. Continuous parameters are
+// interpolated in their normalised range, so frequencies move evenly on
+// their skewed scale; choices and switches flip half way.
+void morphParameters(juce::AudioProcessorValueTreeState& apvts, const ParameterValues& a, const ParameterValues& b, float position);
+
+// Unlisted fields keep ChainSettings' defaults.
+ChainSettings getChainSettings(const ParameterValues& values);
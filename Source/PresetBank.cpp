@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+    PresetBank.cpp
+
+  ==============================================================================
+*/
+
+#include "PresetBank.h"
+
+PresetBank::PresetBank(const juce::AudioProcessorValueTreeState& apvts) {
+    for (juce::AudioProcessorParameter* parameter : apvts.processor.getParameters())
+        if (const juce::RangedAudioParameter* ranged = dynamic_cast<const juce::RangedAudioParameter*>(parameter))
+            if (!isModeParameter(ranged->getParameterID()))
+                defaults.push_back({ ranged->getParameterID(), ranged->convertFrom0to1(ranged->getDefaultValue()) });
+
+    addPreset("Default", {});
+
+    addPreset("Low Cut 80 Hz", {
+        { "LowCutFreq", 80.0f }, { "LowCutSlope", 1.0f } });
+
+    addPreset("Vocal Presence", {
+        { "LowCutFreq", 100.0f }, { "LowCutSlope", 1.0f },
+        { "Band5On", 1.0f }, { "Band5Freq", 300.0f }, { "Band5Gain", -2.5f }, { "Band5Q", 1.2f },
+        { "Peak1Freq", 3000.0f }, { "Peak1Gain", 3.0f }, { "Peak1Q", 1.0f },
+        { "Peak2Type", static_cast<float>(HighShelf) }, { "Peak2Freq", 8000.0f }, { "Peak2Gain", 2.0f }, { "Peak2Q", 0.71f } });
+
+    addPreset("Bass Boost", {
+        { "LowCutFreq", 30.0f }, { "LowCutSlope", 2.0f },
+        { "Band5On", 1.0f }, { "Band5Type", static_cast<float>(LowShelf) }, { "Band5Freq", 100.0f }, { "Band5Gain", 4.0f }, { "Band5Q", 0.71f } });
+
+    addPreset("Air", {
+        { "Peak2Type", static_cast<float>(HighShelf) }, { "Peak2Freq", 10000.0f }, { "Peak2Gain", 4.0f }, { "Peak2Q", 0.71f } });
+
+    addPreset("De-mud", {
+        { "Band5On", 1.0f }, { "Band5Freq", 250.0f }, { "Band5Gain", -3.0f }, { "Band5Q", 1.0f },
+        { "Peak1Freq", 500.0f }, { "Peak1Gain", -2.0f }, { "Peak1Q", 1.4f } });
+
+    addPreset("Telephone", {
+        { "LowCutFreq", 400.0f }, { "LowCutSlope", 3.0f },
+        { "HighCutFreq", 3400.0f }, { "HighCutSlope", 3.0f },
+        { "Peak1Freq", 1500.0f }, { "Peak1Gain", 6.0f }, { "Peak1Q", 0.7f } });
+
+    addPreset("Hum Notch 60 Hz", {
+        { "Band5On", 1.0f }, { "Band5Type", static_cast<float>(Notch) }, { "Band5Freq", 60.0f }, { "Band5Q", 10.0f },
+        { "Band6On", 1.0f }, { "Band6Type", static_cast<float>(Notch) }, { "Band6Freq", 120.0f }, { "Band6Q", 10.0f },
+        { "Band7On", 1.0f }, { "Band7Type", static_cast<float>(Notch) }, { "Band7Freq", 180.0f }, { "Band7Q", 10.0f } });
+}
+
+void PresetBank::addPreset(const juce::String& name, std::initializer_list<ParameterValue> changes) {
+    Preset preset{ name, defaults, {} };
+
+    for (const ParameterValue& change : changes)
+        for (ParameterValue& parameter : preset.parameters)
+            if (parameter.id == change.id)
+                parameter.value = change.value;
+
+    preset.settings = getChainSettings(preset.parameters);
+    presets.push_back(std::move(preset));
+}
+
+void PresetBank::prepare(double sampleRate, CoefficientCache* cache) {
+    designs.resize(presets.size() * static_cast<size_t>(numOversamplingOrders));
+
+    for (size_t index = 0; index < presets.size(); ++index) {
+        for (int order = 0; order < numOversamplingOrders; ++order) {
+            // Linear-phase mode builds its kernels from the pipeline's sets,
+            // so only the IIR path gets precomputed designs.
+            ChainSettings settings = presets[index].settings;
+            settings.oversamplingOrder = order;
+            settings.linearPhase = false;
+
+            designs[index * static_cast<size_t>(numOversamplingOrders) + static_cast<size_t>(order)] = designEQCoefficients(settings, getProcessingSampleRate(settings, sampleRate), cache);
+        }
+    }
+
+    pendingIndex.store(-1);
+}
+
+void PresetBank::setCurrentIndex(int index) noexcept {
+    if (juce::isPositiveAndBelow(index, getNumPresets()))
+        currentIndex.store(index);
+}
+
+void PresetBank::select(int index) noexcept {
+    if (!juce::isPositiveAndBelow(index, getNumPresets()))
+        return;
+
+    currentIndex.store(index);
+    pendingIndex.store(index, std::memory_order_release);
+}
+
+const EQCoefficients* PresetBank::acquire(int oversamplingOrder) noexcept {
+    if (pendingIndex.load(std::memory_order_relaxed) < 0)
+        return nullptr;
+
+    const int index = pendingIndex.exchange(-1, std::memory_order_acquire);
+    if (index < 0 || designs.empty())
+        return nullptr;
+
+    const int order = juce::jlimit(0, numOversamplingOrders - 1, oversamplingOrder);
+    return &designs[static_cast<size_t>(index * numOversamplingOrders + order)];
+}
@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+    PresetBank.h
+
+    The factory presets behind the plugin's programs. Every preset is
+    designed for every oversampling order when playback is prepared, so
+    switching to one on the audio thread is only a pointer swap; the
+    parameters follow on the message thread.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "CoefficientCache.h"
+#include "EQCoefficients.h"
+#include "EQEngine.h"
+#include "PluginState.h"
+
+//==============================================================================
+class PresetBank {
+public:
+    struct Preset {
+        juce::String name;
+        ParameterValues parameters;     // every parameter except the mode ones
+        ChainSettings settings;
+    };
+
+    static constexpr int numOversamplingOrders = EQEngine::maxOversamplingOrder + 1;
+
+    // Presets start from the parameters' defaults.
+    explicit PresetBank(const juce::AudioProcessorValueTreeState& apvts);
+
+    int getNumPresets() const noexcept { return static_cast<int>(presets.size()); }
+    const Preset& getPreset(int index) const noexcept { return presets[static_cast<size_t>(index)]; }
+
+    // Designs every preset for the given rate. Allocates; only call while
+    // the audio thread isn't running, e.g. from prepareToPlay.
+    void prepare(double sampleRate, CoefficientCache* cache);
+
+    int getCurrentIndex() const noexcept { return currentIndex.load(std::memory_order_relaxed); }
+
+    // Records the current preset without switching to it, e.g. on a state restore.
+    void setCurrentIndex(int index) noexcept;
+
+    // Makes the preset current and has the audio thread switch to it.
+    void select(int index) noexcept;
+
+    // Audio thread. The design of a newly selected preset for the given
+    // oversampling order, otherwise nullptr. Valid until the next prepare.
+    const EQCoefficients* acquire(int oversamplingOrder) noexcept;
+
+private:
+    void addPreset(const juce::String& name, std::initializer_list<ParameterValue> changes);
+
+    ParameterValues defaults;
+    std::vector<Preset> presets;
+    std::vector<EQCoefficients> designs;    // numOversamplingOrders per preset
+
+    std::atomic<int> currentIndex{ 0 };
+    std::atomic<int> pendingIndex{ -1 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetBank)
+};
@@ -0,0 +1,151 @@
+/*
+  ==============================================================================
+
+    RealtimeWorkerPool.cpp
+
+  ==============================================================================
+*/
+
+#include "RealtimeWorkerPool.h"
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+#endif
+
+// Tells the core it's in a spin-wait, so a hyperthread sibling gets the
+// pipeline meanwhile.
+static void pauseWhileSpinning() noexcept {
+   #if JUCE_INTEL
+    _mm_pause();
+   #else
+    std::this_thread::yield();
+   #endif
+}
+
+//==============================================================================
+RealtimeWorkerPool::Worker::Worker(RealtimeWorkerPool& owner, int workerSlot)
+    : juce::Thread("EQ Realtime Worker " + juce::String(workerSlot)), pool(owner), slot(workerSlot) {
+}
+
+void RealtimeWorkerPool::Worker::run() {
+    // The audio thread's ScopedNoDenormals doesn't reach this thread.
+    juce::FloatVectorOperations::disableDenormalisedNumberSupport();
+
+    juce::uint32 lastGeneration = pool.generation.load(std::memory_order_acquire);
+
+    while (!threadShouldExit()) {
+        if (!pool.waitForJob(*this, lastGeneration))
+            continue;
+
+        lastGeneration = pool.generation.load(std::memory_order_acquire);
+        pool.joinJob(slot);
+    }
+}
+
+//==============================================================================
+RealtimeWorkerPool::RealtimeWorkerPool(int numWorkers, double sampleRate, int blockSize) {
+    numWorkers = juce::jmax(1, numWorkers);
+    sampleRate = sampleRate > 0.0 ? sampleRate : 44100.0;
+    blockSize = juce::jmax(1, blockSize);
+
+    // A quarter of a block, at most 250 us: long enough to catch the next
+    // block when the last one took most of the budget, short enough not to
+    // hold a core when there's time to wake up.
+    const double spinSeconds = juce::jmin(0.25 * blockSize / sampleRate, 250.0e-6);
+    spinTicks = static_cast<juce::int64>(spinSeconds * static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()));
+
+    for (int index = 0; index < numWorkers; ++index)
+        workers.add(new Worker(*this, index + 1));
+
+    const juce::Thread::RealtimeOptions options = juce::Thread::RealtimeOptions{}.withApproximateAudioProcessingTime(blockSize, sampleRate);
+
+    // Without the privileges for realtime scheduling, as high as we may go.
+    for (Worker* worker : workers)
+        if (!worker->startRealtimeThread(options))
+            worker->startThread(juce::Thread::Priority::highest);
+}
+
+RealtimeWorkerPool::~RealtimeWorkerPool() {
+    for (Worker* worker : workers)
+        worker->signalThreadShouldExit();
+
+    for (Worker* worker : workers) {
+        worker->wakeUp.signal();
+        worker->stopThread(2000);
+    }
+}
+
+bool RealtimeWorkerPool::waitForJob(Worker& worker, juce::uint32 lastGeneration) {
+    const juce::int64 spinUntil = juce::Time::getHighResolutionTicks() + spinTicks;
+
+    while (juce::Time::getHighResolutionTicks() < spinUntil) {
+        if (generation.load(std::memory_order_acquire) != lastGeneration)
+            return true;
+
+        pauseWhileSpinning();
+    }
+
+    // Announce the sleep before the last look, and run() bumps the
+    // generation before it looks for sleepers: one of the two always sees
+    // the other, so no wake-up is lost.
+    sleepingWorkers.fetch_add(1);
+
+    if (generation.load() == lastGeneration)
+        worker.wakeUp.wait(100);
+
+    sleepingWorkers.fetch_sub(1);
+    return generation.load(std::memory_order_acquire) != lastGeneration;
+}
+
+void RealtimeWorkerPool::joinJob(int slot) noexcept {
+    // Counted as active before looking at jobOpen, so run() can't return,
+    // and the next job can't rewrite the fields, while this worker reads them.
+    activeWorkers.fetch_add(1);
+
+    if (jobOpen.load())
+        runTasks(slot);
+
+    activeWorkers.fetch_sub(1, std::memory_order_release);
+}
+
+void RealtimeWorkerPool::runTasks(int slot) noexcept {
+    for (;;) {
+        const int task = nextTask.fetch_add(1, std::memory_order_relaxed);
+        if (task >= jobTasks)
+            return;
+
+        jobFunction(jobContext, task, slot);
+        completedTasks.fetch_add(1, std::memory_order_release);
+    }
+}
+
+void RealtimeWorkerPool::run(int numTasks, TaskFunction function, void* context) noexcept {
+    if (numTasks <= 0)
+        return;
+
+    jassert(!jobOpen.load(std::memory_order_relaxed));
+
+    jobFunction = function;
+    jobContext = context;
+    jobTasks = numTasks;
+    nextTask.store(0, std::memory_order_relaxed);
+    completedTasks.store(0, std::memory_order_relaxed);
+
+    jobOpen.store(true);
+    generation.fetch_add(1);
+
+    if (sleepingWorkers.load() > 0)
+        for (Worker* worker : workers)
+            worker->wakeUp.signal();
+
+    runTasks(0);
+
+    // The barrier: every task done, then every worker out of the job.
+    while (completedTasks.load(std::memory_order_acquire) < numTasks)
+        pauseWhileSpinning();
+
+    jobOpen.store(false);
+
+    while (activeWorkers.load() > 0)
+        pauseWhileSpinning();
+}
@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+    RealtimeWorkerPool.h
+
+    A few pre-spawned realtime-priority threads that help the audio thread
+    through one block's worth of independent tasks. The audio thread
+    publishes a job, takes tasks itself, and returns only once every task
+    has finished; tasks are handed out through one atomic counter, so
+    nothing is queued, allocated or locked.
+
+    Between jobs the workers spin for a short while, so back-to-back blocks
+    find them awake, and then sleep. Waking a sleeping worker is the one
+    thing that can make the audio thread signal an event; the job doesn't
+    wait for it, since the audio thread never stops taking tasks itself.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+class RealtimeWorkerPool {
+public:
+    // Called with the task's index and the slot of the thread running it:
+    // 0 for the thread that called run, 1..getNumWorkers() for the workers.
+    using TaskFunction = void (*)(void* context, int task, int slot);
+
+    // Starts the workers with realtime priority for the given block timing.
+    // Not realtime safe.
+    RealtimeWorkerPool(int numWorkers, double sampleRate, int blockSize);
+    ~RealtimeWorkerPool();
+
+    int getNumWorkers() const noexcept { return workers.size(); }
+    int getNumSlots() const noexcept { return getNumWorkers() + 1; }
+
+    // Runs function(context, task, slot) once for every task in [0, numTasks)
+    // and returns when all of them have finished. One caller at a time.
+    void run(int numTasks, TaskFunction function, void* context) noexcept;
+
+    template <typename Callable>
+    void run(int numTasks, Callable& callable) noexcept {
+        run(numTasks, [](void* context, int task, int slot) { (*static_cast<Callable*>(context))(task, slot); }, &callable);
+    }
+
+private:
+    struct Worker : juce::Thread {
+        Worker(RealtimeWorkerPool& owner, int slot);
+        void run() override;
+
+        RealtimeWorkerPool& pool;
+        const int slot;
+        juce::WaitableEvent wakeUp;
+    };
+
+    bool waitForJob(Worker& worker, juce::uint32 lastGeneration);
+    void joinJob(int slot) noexcept;
+    void runTasks(int slot) noexcept;
+
+    juce::OwnedArray<Worker> workers;
+    juce::int64 spinTicks{ 0 };
+
+    // The current job. Written by run before jobOpen is set, and only read
+    // by workers that have seen it set.
+    TaskFunction jobFunction{ nullptr };
+    void* jobContext{ nullptr };
+    int jobTasks{ 0 };
+
+    std::atomic<juce::uint32> generation{ 0 };
+    std::atomic<bool> jobOpen{ false };
+    std::atomic<int> nextTask{ 0 };
+    std::atomic<int> completedTasks{ 0 };
+    std::atomic<int> activeWorkers{ 0 };
+    std::atomic<int> sleepingWorkers{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RealtimeWorkerPool)
+};
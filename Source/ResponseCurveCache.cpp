@@ -0,0 +1,145 @@
+/*
+  ==============================================================================
+
+    ResponseCurveCache.cpp
+
+  ==============================================================================
+*/
+
+#include "ResponseCurveCache.h"
+
+static bool sameBand(const BandCoefficients& a, const BandCoefficients& b) noexcept {
+    if (a.numSections != b.numSections)
+        return false;
+
+    for (int section = 0; section < a.numSections; ++section) {
+        const BiquadCoefficients& x = a.sections[static_cast<size_t>(section)];
+        const BiquadCoefficients& y = b.sections[static_cast<size_t>(section)];
+
+        if (x.b0 != y.b0 || x.b1 != y.b1 || x.b2 != y.b2 || x.a1 != y.a1 || x.a2 != y.a2)
+            return false;
+    }
+
+    return true;
+}
+
+//==============================================================================
+void ResponseCurveCache::setGrid(double newSampleRate, int newNumPoints) {
+    jassert(newNumPoints > 1);
+
+    if (newSampleRate == sampleRate && newNumPoints == numPoints)
+        return;
+
+    sampleRate = newSampleRate;
+    numPoints = newNumPoints;
+    kernels = &DSPKernels::select();
+
+    for (std::vector<float>* vector : { &cosOmega, &sinOmega, &cos2Omega, &sin2Omega,
+                                        &numeratorReal, &numeratorImag, &denominatorReal, &denominatorImag, &powerRatio })
+        vector->assign(static_cast<size_t>(numPoints), 0.0f);
+
+    for (size_t point = 0; point < static_cast<size_t>(numPoints); ++point) {
+        const double omega = juce::MathConstants<double>::twoPi * getFrequency(static_cast<int>(point)) / sampleRate;
+
+        cosOmega[point] = static_cast<float>(std::cos(omega));
+        sinOmega[point] = static_cast<float>(std::sin(omega));
+        cos2Omega[point] = static_cast<float>(std::cos(2.0 * omega));
+        sin2Omega[point] = static_cast<float>(std::sin(2.0 * omega));
+    }
+
+    for (BandCurve& curve : bands) {
+        curve.valid = false;
+        curve.magnitude.assign(static_cast<size_t>(numPoints), 0.0f);
+        curve.phase.assign(static_cast<size_t>(numPoints), 0.0f);
+    }
+
+    totalMagnitude.assign(static_cast<size_t>(numPoints), 0.0f);
+    totalPhase.assign(static_cast<size_t>(numPoints), 0.0f);
+}
+
+void ResponseCurveCache::setPhaseEnabled(bool shouldComputePhase) {
+    if (phaseEnabled == shouldComputePhase)
+        return;
+
+    phaseEnabled = shouldComputePhase;
+
+    // Magnitudes are still valid, but the phase was never evaluated.
+    if (phaseEnabled)
+        for (BandCurve& curve : bands)
+            curve.valid = false;
+}
+
+double ResponseCurveCache::getFrequency(int point) const noexcept {
+    return juce::mapToLog10(static_cast<double>(point) / static_cast<double>(numPoints - 1), minFrequency, maxFrequency);
+}
+
+bool ResponseCurveCache::update(const EQCoefficients& coefficients) {
+    if (numPoints == 0 || coefficients.sampleRate != sampleRate)
+        setGrid(coefficients.sampleRate, numPoints > 0 ? numPoints : defaultNumPoints);
+
+    bool changed = false;
+
+    for (size_t band = 0; band < bands.size(); ++band) {
+        BandCurve& curve = bands[band];
+
+        if (curve.valid && sameBand(curve.coefficients, coefficients.bands[band]))
+            continue;
+
+        curve.coefficients = coefficients.bands[band];
+        evaluateBand(curve);
+        curve.valid = true;
+        changed = true;
+    }
+
+    if (changed)
+        sumBands();
+
+    return changed;
+}
+
+void ResponseCurveCache::evaluateBand(BandCurve& curve) {
+    std::fill(curve.magnitude.begin(), curve.magnitude.end(), 0.0f);
+    std::fill(curve.phase.begin(), curve.phase.end(), 0.0f);
+
+    const DSPKernels::ResponseGrid grid{ cosOmega.data(), sinOmega.data(), cos2Omega.data(), sin2Omega.data(), numPoints };
+    const DSPKernels::SectionResponse response{ numeratorReal.data(), numeratorImag.data(),
+                                                denominatorReal.data(), denominatorImag.data(), powerRatio.data() };
+
+    for (int section = 0; section < curve.coefficients.numSections; ++section) {
+        const BiquadCoefficients& c = curve.coefficients.sections[static_cast<size_t>(section)];
+        const float coefficients[] = { c.b0, c.b1, c.b2, c.a1, c.a2 };
+
+        kernels->response(grid, coefficients, response);
+
+        // Accumulate in dB per section: the product of deep cut sections
+        // underflows a float long before it becomes inaudible.
+        for (int point = 0; point < numPoints; ++point)
+            curve.magnitude[static_cast<size_t>(point)] += 10.0f * std::log10(response.powerRatio[point]);
+
+        if (phaseEnabled)
+            for (int point = 0; point < numPoints; ++point)
+                curve.phase[static_cast<size_t>(point)] += std::atan2(response.numeratorImag[point], response.numeratorReal[point])
+                                                         - std::atan2(response.denominatorImag[point], response.denominatorReal[point]);
+    }
+}
+
+void ResponseCurveCache::sumBands() {
+    std::fill(totalMagnitude.begin(), totalMagnitude.end(), 0.0f);
+    std::fill(totalPhase.begin(), totalPhase.end(), 0.0f);
+
+    // Inactive bands have flat, all-zero curves.
+    for (const BandCurve& curve : bands) {
+        if (curve.coefficients.numSections == 0)
+            continue;
+
+        juce::FloatVectorOperations::add(totalMagnitude.data(), curve.magnitude.data(), numPoints);
+
+        if (phaseEnabled)
+            juce::FloatVectorOperations::add(totalPhase.data(), curve.phase.data(), numPoints);
+    }
+
+    // Wrap the summed phase back into (-pi, pi] for display.
+    if (phaseEnabled)
+        for (float& phase : totalPhase)
+            phase = std::remainder(phase, juce::MathConstants<float>::twoPi);
+}
@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+
+    ResponseCurveCache.h
+
+    Magnitude (and optionally phase) response of every band on a fixed
+    log-frequency grid. Only bands whose coefficients changed are
+    re-evaluated, and the complex frequency response is computed by the
+    DSPKernels variant picked when the grid is set.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "EQCoefficients.h"
+#include "DSPKernels.h"
+
+//==============================================================================
+class ResponseCurveCache {
+public:
+    static constexpr int defaultNumPoints = 512;
+    static constexpr double minFrequency = 20.0;
+    static constexpr double maxFrequency = 20000.0;
+
+    ResponseCurveCache() = default;
+
+    // Rebuilds the grid if the sample rate or resolution changed, picking
+    // the kernels again. Invalidates every band.
+    void setGrid(double sampleRate, int numPoints = defaultNumPoints);
+
+    void setPhaseEnabled(bool shouldComputePhase);
+    bool isPhaseEnabled() const noexcept { return phaseEnabled; }
+
+    // Re-evaluates the bands whose coefficients differ from the cached ones.
+    // Returns true if any curve changed.
+    bool update(const EQCoefficients& coefficients);
+
+    int getNumPoints() const noexcept { return numPoints; }
+
+    // Grid point i sits at mapToLog10(i / (numPoints - 1), minFrequency, maxFrequency).
+    double getFrequency(int point) const noexcept;
+
+    const float* getTotalMagnitude() const noexcept { return totalMagnitude.data(); }
+    bool isBandActive(int band) const noexcept { return bands[static_cast<size_t>(band)].coefficients.numSections > 0; }
+    const float* getBandMagnitude(int band) const noexcept { return bands[static_cast<size_t>(band)].magnitude.data(); }
+    const float* getTotalPhase() const noexcept { return totalPhase.data(); }
+
+private:
+    struct BandCurve {
+        BandCoefficients coefficients;
+        bool valid{ false };
+        std::vector<float> magnitude;   // dB
+        std::vector<float> phase;       // radians
+    };
+
+    void evaluateBand(BandCurve& curve);
+    void sumBands();
+
+    double sampleRate{ 0.0 };
+    int numPoints{ 0 };
+    bool phaseEnabled{ false };
+
+    // e^-jw and e^-2jw for every grid point, and one section's response.
+    std::vector<float> cosOmega, sinOmega, cos2Omega, sin2Omega;
+    std::vector<float> numeratorReal, numeratorImag, denominatorReal, denominatorImag, powerRatio;
+    const DSPKernels* kernels{ DSPKernels::get(DSPKernels::Scalar) };
+
+    std::array<BandCurve, EQCoefficients::numBands> bands;
+    std::vector<float> totalMagnitude, totalPhase;
+};
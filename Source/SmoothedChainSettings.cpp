@@ -0,0 +1,150 @@
+/*
+  ==============================================================================
+
+    SmoothedChainSettings.cpp
+
+  ==============================================================================
+*/
+
+#include "SmoothedChainSettings.h"
+
+void SmoothedChainSettings::prepare(double sampleRate) {
+    for (FrequencySmoother* smoother : { &peak1Frequency, &peak2Frequency, &lowCutFrequency, &highCutFrequency, &peak1Quality, &peak2Quality })
+        smoother->reset(sampleRate, rampLengthSeconds);
+
+    for (LinearSmoother* smoother : { &peak1Gain, &peak2Gain, &outputGain })
+        smoother->reset(sampleRate, rampLengthSeconds);
+
+    for (BandSmoother& band : extraBands) {
+        band.frequency.reset(sampleRate, rampLengthSeconds);
+        band.quality.reset(sampleRate, rampLengthSeconds);
+        band.gain.reset(sampleRate, rampLengthSeconds);
+    }
+
+    setCurrentAndTarget(current);
+}
+
+void SmoothedChainSettings::setCurrentAndTarget(const ChainSettings& chainSettings) noexcept {
+    current = chainSettings;
+    pendingBands = 0;
+
+    peak1Frequency.setCurrentAndTargetValue(chainSettings.peak1Frequency);
+    peak1Gain.setCurrentAndTargetValue(chainSettings.peak1GainInDecibels);
+    peak1Quality.setCurrentAndTargetValue(chainSettings.peak1Quality);
+    peak2Frequency.setCurrentAndTargetValue(chainSettings.peak2Frequency);
+    peak2Gain.setCurrentAndTargetValue(chainSettings.peak2GainInDecibels);
+    peak2Quality.setCurrentAndTargetValue(chainSettings.peak2Quality);
+    lowCutFrequency.setCurrentAndTargetValue(chainSettings.lowCutFrequency);
+    highCutFrequency.setCurrentAndTargetValue(chainSettings.highCutFrequency);
+    outputGain.setCurrentAndTargetValue(chainSettings.outputGain);
+
+    for (size_t band = 0; band < extraBands.size(); ++band) {
+        extraBands[band].frequency.setCurrentAndTargetValue(chainSettings.extraBands[band].frequency);
+        extraBands[band].quality.setCurrentAndTargetValue(chainSettings.extraBands[band].quality);
+        extraBands[band].gain.setCurrentAndTargetValue(chainSettings.extraBands[band].gainInDecibels);
+    }
+}
+
+void SmoothedChainSettings::setTarget(const ChainSettings& chainSettings) noexcept {
+    peak1Frequency.setTargetValue(chainSettings.peak1Frequency);
+    peak1Gain.setTargetValue(chainSettings.peak1GainInDecibels);
+    peak1Quality.setTargetValue(chainSettings.peak1Quality);
+    peak2Frequency.setTargetValue(chainSettings.peak2Frequency);
+    peak2Gain.setTargetValue(chainSettings.peak2GainInDecibels);
+    peak2Quality.setTargetValue(chainSettings.peak2Quality);
+    lowCutFrequency.setTargetValue(chainSettings.lowCutFrequency);
+    highCutFrequency.setTargetValue(chainSettings.highCutFrequency);
+    outputGain.setTargetValue(chainSettings.outputGain);
+
+    // Slopes, types and on/off can't be ramped; they switch on the next
+    // sub-block of a running ramp.
+    if (chainSettings.lowCutSlope != current.lowCutSlope)
+        pendingBands |= 1 << ChainPositions::LowCut;
+    if (chainSettings.highCutSlope != current.highCutSlope)
+        pendingBands |= 1 << ChainPositions::HighCut;
+    // A flat peak band is only designed while it is dynamic.
+    if (chainSettings.peak1Type != current.peak1Type || chainSettings.peak1Dynamics.enabled != current.peak1Dynamics.enabled)
+        pendingBands |= 1 << ChainPositions::PeakBand1;
+    if (chainSettings.peak2Type != current.peak2Type || chainSettings.peak2Dynamics.enabled != current.peak2Dynamics.enabled)
+        pendingBands |= 1 << ChainPositions::PeakBand2;
+
+    for (size_t band = 0; band < extraBands.size(); ++band) {
+        const BandSettings& target = chainSettings.extraBands[band];
+        BandSettings& bandCurrent = current.extraBands[band];
+
+        extraBands[band].frequency.setTargetValue(target.frequency);
+        extraBands[band].quality.setTargetValue(target.quality);
+        extraBands[band].gain.setTargetValue(target.gainInDecibels);
+
+        if (target.type != bandCurrent.type || target.enabled != bandCurrent.enabled)
+            pendingBands |= 1 << (ChainPositions::FirstExtraBand + static_cast<int>(band));
+
+        bandCurrent.type = target.type;
+        bandCurrent.enabled = target.enabled;
+    }
+
+    // Placement doesn't change a band's design, but the engine only picks it
+    // up with the band's coefficients.
+    for (int position = 0; position < maxBands; ++position)
+        if (chainSettings.placements[static_cast<size_t>(position)] != current.placements[static_cast<size_t>(position)])
+            pendingBands |= 1 << position;
+
+    if (chainSettings.stereoMode != current.stereoMode)
+        pendingBands |= (1 << maxBands) - 1;
+
+    current.lowCutSlope = chainSettings.lowCutSlope;
+    current.highCutSlope = chainSettings.highCutSlope;
+    current.peak1Type = chainSettings.peak1Type;
+    current.peak2Type = chainSettings.peak2Type;
+    current.bypass = chainSettings.bypass;
+    current.peak1Dynamics = chainSettings.peak1Dynamics;
+    current.peak2Dynamics = chainSettings.peak2Dynamics;
+    current.dynamicsFromSidechain = chainSettings.dynamicsFromSidechain;
+    current.stereoMode = chainSettings.stereoMode;
+    current.placements = chainSettings.placements;
+}
+
+bool SmoothedChainSettings::isSmoothing() const noexcept {
+    return peak1Frequency.isSmoothing() || peak1Gain.isSmoothing() || peak1Quality.isSmoothing()
+        || peak2Frequency.isSmoothing() || peak2Gain.isSmoothing() || peak2Quality.isSmoothing()
+        || lowCutFrequency.isSmoothing() || highCutFrequency.isSmoothing() || outputGain.isSmoothing()
+        || std::any_of(extraBands.begin(), extraBands.end(), [](const BandSmoother& band) { return band.isSmoothing(); });
+}
+
+int SmoothedChainSettings::advance(int numSamples) noexcept {
+    int bands = pendingBands;
+    pendingBands = 0;
+
+    if (peak1Frequency.isSmoothing() || peak1Gain.isSmoothing() || peak1Quality.isSmoothing())
+        bands |= 1 << ChainPositions::PeakBand1;
+    if (peak2Frequency.isSmoothing() || peak2Gain.isSmoothing() || peak2Quality.isSmoothing())
+        bands |= 1 << ChainPositions::PeakBand2;
+    if (lowCutFrequency.isSmoothing())
+        bands |= 1 << ChainPositions::LowCut;
+    if (highCutFrequency.isSmoothing())
+        bands |= 1 << ChainPositions::HighCut;
+
+    current.peak1Frequency = peak1Frequency.skip(numSamples);
+    current.peak1GainInDecibels = peak1Gain.skip(numSamples);
+    current.peak1Quality = peak1Quality.skip(numSamples);
+    current.peak2Frequency = peak2Frequency.skip(numSamples);
+    current.peak2GainInDecibels = peak2Gain.skip(numSamples);
+    current.peak2Quality = peak2Quality.skip(numSamples);
+    current.lowCutFrequency = lowCutFrequency.skip(numSamples);
+    current.highCutFrequency = highCutFrequency.skip(numSamples);
+    current.outputGain = outputGain.skip(numSamples);
+
+    for (size_t band = 0; band < extraBands.size(); ++band) {
+        BandSmoother& smoother = extraBands[band];
+        const int position = ChainPositions::FirstExtraBand + static_cast<int>(band);
+
+        if (smoother.isSmoothing())
+            bands |= 1 << position;
+
+        current.extraBands[band].frequency = smoother.frequency.skip(numSamples);
+        current.extraBands[band].quality = smoother.quality.skip(numSamples);
+        current.extraBands[band].gainInDecibels = smoother.gain.skip(numSamples);
+    }
+
+    return bands;
+}
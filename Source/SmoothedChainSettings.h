@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    SmoothedChainSettings.h
+
+    Ramps the continuous EQ parameters towards their targets so coefficient
+    changes are spread over a fixed sub-block grid instead of jumping once
+    per host block.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ChainSettings.h"
+
+//==============================================================================
+class SmoothedChainSettings {
+public:
+    // Coefficients are recomputed once per sub-block while a ramp is running,
+    // which bounds the design cost to numSamples / subBlockSize per moving band.
+    static constexpr int subBlockSize = 32;
+    static constexpr double rampLengthSeconds = 0.05;
+
+    void prepare(double sampleRate);
+
+    // Jumps straight to the given settings without ramping.
+    void setCurrentAndTarget(const ChainSettings& chainSettings) noexcept;
+    void setTarget(const ChainSettings& chainSettings) noexcept;
+
+    bool isSmoothing() const noexcept;
+
+    // Moves every ramp on by numSamples and returns the bands (bit n == ChainPositions n)
+    // whose coefficients need redesigning for the new current settings. The
+    // output gain ramps too but isn't a band; it is read from getCurrent().
+    int advance(int numSamples) noexcept;
+
+    const ChainSettings& getCurrent() const noexcept { return current; }
+
+private:
+    using FrequencySmoother = juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative>;
+    using LinearSmoother = juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear>;
+
+    FrequencySmoother peak1Frequency, peak2Frequency, lowCutFrequency, highCutFrequency;
+    FrequencySmoother peak1Quality, peak2Quality;
+    LinearSmoother peak1Gain, peak2Gain, outputGain;
+
+    struct BandSmoother {
+        FrequencySmoother frequency, quality;
+        LinearSmoother gain;
+
+        bool isSmoothing() const noexcept { return frequency.isSmoothing() || quality.isSmoothing() || gain.isSmoothing(); }
+    };
+
+    std::array<BandSmoother, numExtraBands> extraBands;
+
+    ChainSettings current;
+    int pendingBands{ 0 };
+};
@@ -0,0 +1,263 @@
+/*
+  ==============================================================================
+
+    SpectrumAnalyzer.cpp
+
+  ==============================================================================
+*/
+
+#include "SpectrumAnalyzer.h"
+
+void AnalyzerFifo::prepare(int capacity) {
+    buffer.assign(static_cast<size_t>(capacity), 0.0f);
+    fifo.setTotalSize(capacity);
+}
+
+void AnalyzerFifo::reset() noexcept {
+    fifo.reset();
+}
+
+void AnalyzerFifo::push(const juce::dsp::AudioBlock<float>& block) noexcept {
+    const int numChannels = static_cast<int>(block.getNumChannels());
+    if (numChannels == 0)
+        return;
+
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(static_cast<int>(block.getNumSamples()), start1, size1, start2, size2);
+
+    const float channelGain = 1.0f / static_cast<float>(numChannels);
+
+    auto mixDown = [&](int destination, int source, int numSamples) {
+        if (numSamples <= 0)
+            return;
+
+        float* output = buffer.data() + destination;
+        juce::FloatVectorOperations::copyWithMultiply(output, block.getChannelPointer(0) + source, channelGain, numSamples);
+
+        for (int channel = 1; channel < numChannels; ++channel)
+            juce::FloatVectorOperations::addWithMultiply(output, block.getChannelPointer(static_cast<size_t>(channel)) + source, channelGain, numSamples);
+        };
+
+    mixDown(start1, 0, size1);
+    mixDown(start2, size1, size2);
+
+    fifo.finishedWrite(size1 + size2);
+}
+
+void AnalyzerFifo::pull(float* destination, int numSamples) noexcept {
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(numSamples, start1, size1, start2, size2);
+
+    if (size1 > 0)
+        std::copy_n(buffer.data() + start1, size1, destination);
+    if (size2 > 0)
+        std::copy_n(buffer.data() + start2, size2, destination + size1);
+
+    fifo.finishedRead(size1 + size2);
+}
+
+void AnalyzerFifo::discard(int numSamples) noexcept {
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(numSamples, start1, size1, start2, size2);
+    fifo.finishedRead(size1 + size2);
+}
+
+//==============================================================================
+AnalyzerThread::AnalyzerThread() : juce::TimeSliceThread("EQ Spectrum Analyzer") {
+    startThread();
+}
+
+AnalyzerThread::~AnalyzerThread() {
+    stopThread(1000);
+}
+
+//==============================================================================
+SpectrumAnalyzer::SpectrumAnalyzer() {
+    for (Channel& channel : channels) {
+        channel.fifo.prepare(fftSize * 8);
+        channel.history.assign(static_cast<size_t>(fftSize), 0.0f);
+        channel.fftData.assign(static_cast<size_t>(fftSize * 2), 0.0f);
+        channel.averageBins.assign(static_cast<size_t>(fftSize / 2), minDecibels);
+        channel.peakBins.assign(static_cast<size_t>(fftSize / 2), minDecibels);
+    }
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer() {
+    analyzerThread->removeTimeSliceClient(this);
+}
+
+void SpectrumAnalyzer::prepare(double newSampleRate) {
+    const juce::ScopedLock sl(lock);
+
+    sampleRate = newSampleRate;
+
+    // Enough for the analyzer thread to fall a few hops behind at high sample rates.
+    const int capacity = juce::jmax(fftSize * 8, juce::nextPowerOfTwo(juce::roundToInt(sampleRate / 4.0)));
+    for (Channel& channel : channels)
+        channel.fifo.prepare(capacity);
+
+    resetChannels();
+    updateColumnMapping();
+}
+
+void SpectrumAnalyzer::setEnabled(bool shouldBeEnabled) {
+    if (enabled.exchange(shouldBeEnabled) == shouldBeEnabled)
+        return;
+
+    if (shouldBeEnabled)
+        analyzerThread->addTimeSliceClient(this);
+    else
+        analyzerThread->removeTimeSliceClient(this);
+}
+
+void SpectrumAnalyzer::pushSamples(Source source, const juce::dsp::AudioBlock<float>& block) noexcept {
+    channels[static_cast<size_t>(source)].fifo.push(block);
+}
+
+void SpectrumAnalyzer::setDisplayRange(int newNumColumns, double newMinFrequency, double newMaxFrequency) {
+    const juce::ScopedLock sl(lock);
+
+    if (newNumColumns == numColumns && newMinFrequency == minFrequency && newMaxFrequency == maxFrequency)
+        return;
+
+    numColumns = juce::jmax(0, newNumColumns);
+    minFrequency = newMinFrequency;
+    maxFrequency = newMaxFrequency;
+
+    updateColumnMapping();
+}
+
+bool SpectrumAnalyzer::copyFrame(Source source, std::vector<float>& average, std::vector<float>& peak) const {
+    const juce::ScopedLock sl(lock);
+
+    if (!hasFrame || numColumns == 0)
+        return false;
+
+    const Channel& channel = channels[static_cast<size_t>(source)];
+    average = channel.averageColumns;
+    peak = channel.peakColumns;
+    return true;
+}
+
+int SpectrumAnalyzer::useTimeSlice() {
+    const juce::ScopedLock sl(lock);
+
+    if (sampleRate <= 0.0)
+        return idleIntervalMs;
+
+    bool analysed = false;
+
+    for (Channel& channel : channels) {
+        // After a stall (or re-opening the editor) only the newest audio is worth showing.
+        const int backlog = channel.fifo.getNumReady() - fftSize;
+        if (backlog > 0)
+            channel.fifo.discard(backlog - backlog % hopSize);
+
+        while (channel.fifo.getNumReady() >= hopSize) {
+            std::copy(channel.history.begin() + hopSize, channel.history.end(), channel.history.begin());
+            channel.fifo.pull(channel.history.data() + fftSize - hopSize, hopSize);
+
+            analyseFrame(channel);
+            analysed = true;
+        }
+    }
+
+    if (!analysed)
+        return idleIntervalMs;
+
+    for (Channel& channel : channels) {
+        decimate(channel.averageBins, channel.averageColumns);
+        decimate(channel.peakBins, channel.peakColumns);
+    }
+
+    hasFrame = numColumns > 0;
+    frameCounter.fetch_add(1, std::memory_order_release);
+
+    return idleIntervalMs;
+}
+
+void SpectrumAnalyzer::analyseFrame(Channel& channel) {
+    std::copy(channel.history.begin(), channel.history.end(), channel.fftData.begin());
+    std::fill(channel.fftData.begin() + fftSize, channel.fftData.end(), 0.0f);
+
+    window.multiplyWithWindowingTable(channel.fftData.data(), static_cast<size_t>(fftSize));
+    fft.performFrequencyOnlyForwardTransform(channel.fftData.data(), true);
+
+    // The window is normalised, so a full-scale sine reads 0 dB.
+    const float magnitudeScale = 2.0f / static_cast<float>(fftSize);
+    const float peakDecay = peakDecayDecibelsPerSecond * static_cast<float>(hopSize / sampleRate);
+
+    for (int bin = 0; bin < fftSize / 2; ++bin) {
+        const float level = juce::Decibels::gainToDecibels(channel.fftData[static_cast<size_t>(bin)] * magnitudeScale, minDecibels);
+
+        float& average = channel.averageBins[static_cast<size_t>(bin)];
+        average = averagingFactor * average + (1.0f - averagingFactor) * level;
+
+        float& peak = channel.peakBins[static_cast<size_t>(bin)];
+        peak = juce::jmax(level, peak - peakDecay);
+    }
+}
+
+void SpectrumAnalyzer::resetChannels() {
+    for (Channel& channel : channels) {
+        channel.fifo.reset();
+        std::fill(channel.history.begin(), channel.history.end(), 0.0f);
+        std::fill(channel.averageBins.begin(), channel.averageBins.end(), minDecibels);
+        std::fill(channel.peakBins.begin(), channel.peakBins.end(), minDecibels);
+    }
+}
+
+void SpectrumAnalyzer::updateColumnMapping() {
+    hasFrame = false;
+
+    columnStartBins.resize(static_cast<size_t>(numColumns));
+    columnEndBins.resize(static_cast<size_t>(numColumns));
+
+    for (Channel& channel : channels) {
+        channel.averageColumns.assign(static_cast<size_t>(numColumns), minDecibels);
+        channel.peakColumns.assign(static_cast<size_t>(numColumns), minDecibels);
+    }
+
+    if (sampleRate <= 0.0)
+        return;
+
+    const double binsPerHz = fftSize / sampleRate;
+
+    for (int column = 0; column < numColumns; ++column) {
+        const double start = juce::mapToLog10(static_cast<double>(column) / numColumns, minFrequency, maxFrequency);
+        const double end = juce::mapToLog10(static_cast<double>(column + 1) / numColumns, minFrequency, maxFrequency);
+
+        columnStartBins[static_cast<size_t>(column)] = static_cast<float>(start * binsPerHz);
+        columnEndBins[static_cast<size_t>(column)] = static_cast<float>(end * binsPerHz);
+    }
+}
+
+void SpectrumAnalyzer::decimate(const std::vector<float>& bins, std::vector<float>& columns) const {
+    const int lastBin = fftSize / 2 - 1;
+
+    for (int column = 0; column < numColumns; ++column) {
+        const float start = columnStartBins[static_cast<size_t>(column)];
+        const float end = columnEndBins[static_cast<size_t>(column)];
+        float level;
+
+        if (end - start < 1.0f) {
+            // Narrower than a bin: interpolate at the column's centre.
+            const float position = juce::jmin(0.5f * (start + end), static_cast<float>(lastBin));
+            const int index = juce::jmin(static_cast<int>(position), lastBin - 1);
+            const float fraction = position - static_cast<float>(index);
+
+            level = bins[static_cast<size_t>(index)] + fraction * (bins[static_cast<size_t>(index + 1)] - bins[static_cast<size_t>(index)]);
+        }
+        else {
+            // Wider than a bin: keep the loudest one so narrow peaks don't vanish.
+            const int first = juce::jmin(static_cast<int>(start), lastBin);
+            const int last = juce::jmin(static_cast<int>(end), lastBin);
+
+            level = bins[static_cast<size_t>(first)];
+            for (int bin = first + 1; bin <= last; ++bin)
+                level = juce::jmax(level, bins[static_cast<size_t>(bin)]);
+        }
+
+        columns[static_cast<size_t>(column)] = level;
+    }
+}
@@ -0,0 +1,120 @@
+/*
+  ==============================================================================
+
+    SpectrumAnalyzer.h
+
+    Pre- and post-EQ spectra for the editor. The audio thread only pushes
+    samples into wait-free single-producer/single-consumer FIFOs; windowing,
+    FFT, averaging, peak-hold and decimation to pixel columns all run on a
+    shared background thread.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Mono ring buffer between the audio thread (writer) and the analyzer thread (reader).
+class AnalyzerFifo {
+public:
+    void prepare(int capacity);
+    void reset() noexcept;
+
+    // Audio thread. Mixes the block down to mono; whatever doesn't fit is dropped.
+    void push(const juce::dsp::AudioBlock<float>& block) noexcept;
+
+    // Analyzer thread.
+    int getNumReady() const noexcept { return fifo.getNumReady(); }
+    void pull(float* destination, int numSamples) noexcept;
+    void discard(int numSamples) noexcept;
+
+private:
+    juce::AbstractFifo fifo{ 1 };
+    std::vector<float> buffer;
+};
+
+//==============================================================================
+// One low-priority thread shared by every analyzer in the process.
+struct AnalyzerThread : juce::TimeSliceThread {
+    AnalyzerThread();
+    ~AnalyzerThread() override;
+};
+
+//==============================================================================
+class SpectrumAnalyzer : private juce::TimeSliceClient {
+public:
+    enum Source { Pre, Post, numSources };
+
+    static constexpr int fftOrder = 12;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int hopSize = fftSize / 4;
+    static constexpr float minDecibels = -96.0f;
+
+    SpectrumAnalyzer();
+    ~SpectrumAnalyzer() override;
+
+    void prepare(double sampleRate);
+
+    // Called by the editor. While disabled, the audio thread skips the analyzer
+    // entirely and the background thread does no work.
+    void setEnabled(bool shouldBeEnabled);
+    bool isEnabled() const noexcept { return enabled.load(std::memory_order_relaxed); }
+
+    // Audio thread. Never blocks or allocates.
+    void pushSamples(Source source, const juce::dsp::AudioBlock<float>& block) noexcept;
+
+    // Message thread. Columns cover minFrequency..maxFrequency on a log axis.
+    void setDisplayRange(int numColumns, double minFrequency, double maxFrequency);
+
+    // Incremented whenever a new frame has been published.
+    int getFrameCounter() const noexcept { return frameCounter.load(std::memory_order_acquire); }
+
+    // Copies the newest per-column averaged and peak-hold levels in dB. Returns
+    // false if nothing has been analysed yet at the current display width.
+    bool copyFrame(Source source, std::vector<float>& average, std::vector<float>& peak) const;
+
+private:
+    struct Channel {
+        AnalyzerFifo fifo;
+        std::vector<float> history;     // last fftSize samples
+        std::vector<float> fftData;     // 2 * fftSize, as performFrequencyOnlyForwardTransform needs
+        std::vector<float> averageBins; // dB
+        std::vector<float> peakBins;    // dB
+        std::vector<float> averageColumns, peakColumns;
+    };
+
+    int useTimeSlice() override;
+
+    void analyseFrame(Channel& channel);
+    void updateColumnMapping();
+    void resetChannels();
+    void decimate(const std::vector<float>& bins, std::vector<float>& columns) const;
+
+    static constexpr int idleIntervalMs = 10;
+    static constexpr float averagingFactor = 0.7f;
+    static constexpr float peakDecayDecibelsPerSecond = 12.0f;
+
+    juce::SharedResourcePointer<AnalyzerThread> analyzerThread;
+
+    std::atomic<bool> enabled{ false };
+    double sampleRate{ 0.0 };
+
+    juce::dsp::FFT fft{ fftOrder };
+    juce::dsp::WindowingFunction<float> window{ static_cast<size_t>(fftSize), juce::dsp::WindowingFunction<float>::hann };
+    std::array<Channel, numSources> channels;
+
+    // Each column either spans a range of bins or, at the low end where bins
+    // are wider than a pixel, interpolates at a fractional bin.
+    std::vector<float> columnStartBins, columnEndBins;
+    int numColumns{ 0 };
+    double minFrequency{ 20.0 }, maxFrequency{ 20000.0 };
+    bool hasFrame{ false };
+
+    // Guards the settings above and the published columns; never taken by the audio thread.
+    juce::CriticalSection lock;
+    std::atomic<int> frameCounter{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumAnalyzer)
+};
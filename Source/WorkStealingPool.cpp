@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+    WorkStealingPool.cpp
+
+  ==============================================================================
+*/
+
+#include "WorkStealingPool.h"
+
+static thread_local int currentWorkerIndex = -1;
+
+WorkStealingPool::Worker::Worker(WorkStealingPool& owner, int index, const juce::String& name)
+    : juce::Thread(name), pool(owner), workerIndex(index) {
+}
+
+void WorkStealingPool::Worker::run() {
+    currentWorkerIndex = workerIndex;
+
+    while (!threadShouldExit()) {
+        Job job;
+
+        if (pool.popOwnJob(workerIndex, job) || pool.stealJob(workerIndex, job)) {
+            job();
+            pool.jobFinished();
+            continue;
+        }
+
+        wakeUp.wait(10);
+    }
+}
+
+//==============================================================================
+WorkStealingPool::WorkStealingPool(int numWorkers, const juce::String& threadNamePrefix) {
+    numWorkers = juce::jmax(1, numWorkers);
+
+    for (int index = 0; index < numWorkers; ++index)
+        workers.add(new Worker(*this, index, threadNamePrefix + " " + juce::String(index + 1)));
+
+    for (Worker* worker : workers)
+        worker->startThread();
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    for (Worker* worker : workers)
+        worker->signalThreadShouldExit();
+
+    for (Worker* worker : workers) {
+        worker->wakeUp.signal();
+        worker->stopThread(5000);
+    }
+}
+
+int WorkStealingPool::getCurrentWorkerIndex() noexcept {
+    return currentWorkerIndex;
+}
+
+void WorkStealingPool::submit(Job job) {
+    pendingJobs.fetch_add(1);
+
+    const int ownIndex = currentWorkerIndex;
+    const int target = ownIndex >= 0 ? ownIndex : nextWorker.fetch_add(1) % workers.size();
+
+    Worker* worker = workers.getUnchecked(target);
+    {
+        const juce::ScopedLock sl(worker->lock);
+        worker->jobs.push_back(std::move(job));
+    }
+
+    // Idle workers may steal it, so wake everybody rather than just the owner.
+    for (Worker* w : workers)
+        w->wakeUp.signal();
+}
+
+void WorkStealingPool::waitForAll() {
+    while (pendingJobs.load() > 0)
+        allJobsFinished.wait(10);
+}
+
+bool WorkStealingPool::popOwnJob(int workerIndex, Job& job) {
+    Worker* worker = workers.getUnchecked(workerIndex);
+    const juce::ScopedLock sl(worker->lock);
+
+    if (worker->jobs.empty())
+        return false;
+
+    job = std::move(worker->jobs.back());
+    worker->jobs.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::stealJob(int thiefIndex, Job& job) {
+    const int numWorkers = workers.size();
+
+    for (int offset = 1; offset < numWorkers; ++offset) {
+        Worker* victim = workers.getUnchecked((thiefIndex + offset) % numWorkers);
+        const juce::ScopedTryLock stl(victim->lock);
+
+        if (!stl.isLocked() || victim->jobs.empty())
+            continue;
+
+        job = std::move(victim->jobs.front());
+        victim->jobs.pop_front();
+        return true;
+    }
+
+    return false;
+}
+
+void WorkStealingPool::jobFinished() {
+    if (pendingJobs.fetch_sub(1) == 1)
+        allJobsFinished.signal();
+}
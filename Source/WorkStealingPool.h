@@ -0,0 +1,59 @@
+/*
+  ==============================================================================
+
+    WorkStealingPool.h
+
+    Fixed set of worker threads, each with its own job deque. A worker runs
+    its own jobs newest-first and steals the oldest job from another worker
+    when it runs dry, which keeps cores busy when job lengths vary a lot.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+class WorkStealingPool {
+public:
+    using Job = std::function<void()>;
+
+    explicit WorkStealingPool(int numWorkers, const juce::String& threadNamePrefix = "EQ Worker");
+    ~WorkStealingPool();
+
+    // Can be called from any thread. Jobs submitted from a worker go onto that
+    // worker's own deque, others are spread round-robin.
+    void submit(Job job);
+
+    // Blocks until every submitted job has finished.
+    void waitForAll();
+
+    int getNumWorkers() const noexcept { return workers.size(); }
+
+    // Index of the worker running the calling thread, or -1 for other threads.
+    static int getCurrentWorkerIndex() noexcept;
+
+private:
+    struct Worker : juce::Thread {
+        Worker(WorkStealingPool& owner, int index, const juce::String& name);
+        void run() override;
+
+        WorkStealingPool& pool;
+        const int workerIndex;
+        juce::CriticalSection lock;
+        std::deque<Job> jobs;
+        juce::WaitableEvent wakeUp;
+    };
+
+    bool popOwnJob(int workerIndex, Job& job);
+    bool stealJob(int thiefIndex, Job& job);
+    void jobFinished();
+
+    juce::OwnedArray<Worker> workers;
+    std::atomic<int> pendingJobs{ 0 };
+    std::atomic<int> nextWorker{ 0 };
+    juce::WaitableEvent allJobsFinished;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WorkStealingPool)
+};
@@ -0,0 +1,371 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+
+    Microbenchmarks for the realtime path (EqualizerAudioProcessor::processBlock)
+    and for the filter design functions. Reports ns/sample, operator new
+    calls per block on the calling thread, and timing percentiles.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../../Source/PluginProcessor.h"
+
+//==============================================================================
+// Allocation counting: only calls made from a thread that has switched
+// counting on are recorded, so the coefficient designer thread doesn't skew
+// the audio-thread numbers. Memory obtained with malloc directly (e.g. by
+// juce::HeapBlock) is not seen.
+static thread_local bool countAllocationsOnThisThread = false;
+static thread_local juce::int64 allocationsOnThisThread = 0;
+
+static void* countedAllocate(std::size_t size) {
+    if (countAllocationsOnThisThread)
+        ++allocationsOnThisThread;
+
+    if (void* memory = std::malloc(size != 0 ? size : 1))
+        return memory;
+
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size) { return countedAllocate(size); }
+void* operator new[](std::size_t size) { return countedAllocate(size); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+
+struct ScopedAllocationCounter {
+    ScopedAllocationCounter() { allocationsOnThisThread = 0; countAllocationsOnThisThread = true; }
+    ~ScopedAllocationCounter() { countAllocationsOnThisThread = false; }
+    juce::int64 getCount() const noexcept { return allocationsOnThisThread; }
+};
+
+//==============================================================================
+using Clock = std::chrono::steady_clock;
+
+static double nanosecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+struct Percentiles {
+    double mean{ 0 }, p50{ 0 }, p90{ 0 }, p99{ 0 }, max{ 0 };
+};
+
+static Percentiles computePercentiles(std::vector<double>& values) {
+    Percentiles result;
+    if (values.empty())
+        return result;
+
+    std::sort(values.begin(), values.end());
+    auto at = [&values](double fraction) {
+        return values[juce::jmin(values.size() - 1, static_cast<size_t>(fraction * static_cast<double>(values.size())))];
+    };
+
+    result.mean = std::accumulate(values.begin(), values.end(), 0.0) / static_cast<double>(values.size());
+    result.p50 = at(0.5);
+    result.p90 = at(0.9);
+    result.p99 = at(0.99);
+    result.max = values.back();
+    return result;
+}
+
+// Keeps the optimiser from discarding results it can prove unused.
+static volatile float benchmarkSink = 0.0f;
+
+//==============================================================================
+struct ProcessBlockCase {
+    int blockSize;
+    double sampleRate;
+    Slope slope;
+    int numChannels;
+    bool automated;
+    int oversamplingOrder;
+    bool dynamic;
+    int extraBands;
+    int workers;
+};
+
+static void setParameter(EqualizerAudioProcessor& processor, const juce::String& parameterID, float value) {
+    if (juce::RangedAudioParameter* parameter = processor.apvts.getParameter(parameterID))
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+}
+
+static juce::AudioChannelSet getChannelSet(int numChannels) {
+    switch (numChannels) {
+        case 1:  return juce::AudioChannelSet::mono();
+        case 2:  return juce::AudioChannelSet::stereo();
+        case 12: return juce::AudioChannelSet::create7point1point4();
+        default: return juce::AudioChannelSet::discreteChannels(numChannels);
+    }
+}
+
+static void fillWithNoise(juce::AudioBuffer<float>& buffer, juce::Random& random) {
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
+        float* samples = buffer.getWritePointer(channel);
+        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+            samples[sample] = random.nextFloat() * 0.5f - 0.25f;
+    }
+}
+
+static juce::String runProcessBlockCase(const ProcessBlockCase& testCase, int numBlocks) {
+    EqualizerAudioProcessor processor;
+
+    juce::AudioProcessor::BusesLayout layout;
+    layout.inputBuses.add(getChannelSet(testCase.numChannels));
+    layout.outputBuses.add(getChannelSet(testCase.numChannels));
+
+    // The sidechain stays off; dynamic bands key from the main input.
+    for (int bus = 1; bus < processor.getBusCount(true); ++bus)
+        layout.inputBuses.add(juce::AudioChannelSet::disabled());
+
+    if (!processor.setBusesLayout(layout))
+        return "layout not supported";
+
+    // Every band active so the whole cascade is measured.
+    setParameter(processor, "LowCutFreq", 80.0f);
+    setParameter(processor, "HighCutFreq", 12000.0f);
+    setParameter(processor, "LowCutSlope", static_cast<float>(testCase.slope));
+    setParameter(processor, "HighCutSlope", static_cast<float>(testCase.slope));
+    setParameter(processor, "Peak1Gain", 6.0f);
+    setParameter(processor, "Peak2Gain", -4.0f);
+    setParameter(processor, "Oversampling", static_cast<float>(testCase.oversamplingOrder));
+
+    if (testCase.dynamic) {
+        setParameter(processor, "Peak1Dynamic", 1.0f);
+        setParameter(processor, "Peak2Dynamic", 1.0f);
+        setParameter(processor, "Peak1Threshold", -40.0f);
+        setParameter(processor, "Peak2Threshold", -40.0f);
+    }
+
+    // Alternating boosts and cuts so none of them is elided as flat.
+    for (int band = 0; band < testCase.extraBands; ++band) {
+        const int position = ChainPositions::FirstExtraBand + band;
+        setParameter(processor, getBandParameterID(position, "On"), 1.0f);
+        setParameter(processor, getBandParameterID(position, "Gain"), band % 2 == 0 ? 3.0f : -3.0f);
+    }
+
+    processor.setParallelWorkers(testCase.workers);
+    processor.setRateAndBufferSizeDetails(testCase.sampleRate, testCase.blockSize);
+    processor.prepareToPlay(testCase.sampleRate, testCase.blockSize);
+
+    juce::AudioBuffer<float> buffer(testCase.numChannels, testCase.blockSize);
+    juce::MidiBuffer midi;
+    juce::Random random(42);
+
+    std::vector<double> blockTimes;
+    blockTimes.reserve(static_cast<size_t>(numBlocks));
+    juce::int64 totalAllocations = 0;
+
+    const int warmUpBlocks = juce::jmax(16, numBlocks / 10);
+
+    for (int block = -warmUpBlocks; block < numBlocks; ++block) {
+        fillWithNoise(buffer, random);
+
+        if (testCase.automated)
+            setParameter(processor, "Peak1Freq", 500.0f + 4500.0f * static_cast<float>((block + warmUpBlocks) % 256) / 255.0f);
+
+        ScopedAllocationCounter counter;
+        const Clock::time_point start = Clock::now();
+        processor.processBlock(buffer, midi);
+        const double elapsed = nanosecondsSince(start);
+
+        if (block >= 0) {
+            blockTimes.push_back(elapsed);
+            totalAllocations += counter.getCount();
+        }
+    }
+
+    processor.releaseResources();
+    benchmarkSink = buffer.getSample(0, 0);
+
+    const double samplesPerBlock = static_cast<double>(testCase.blockSize) * testCase.numChannels;
+    const Percentiles percentiles = computePercentiles(blockTimes);
+
+    return juce::String(percentiles.mean / samplesPerBlock, 2).paddedLeft(' ', 9)
+         + juce::String(percentiles.p50 / 1000.0, 2).paddedLeft(' ', 10)
+         + juce::String(percentiles.p90 / 1000.0, 2).paddedLeft(' ', 10)
+         + juce::String(percentiles.p99 / 1000.0, 2).paddedLeft(' ', 10)
+         + juce::String(percentiles.max / 1000.0, 2).paddedLeft(' ', 10)
+         + juce::String(static_cast<double>(totalAllocations) / numBlocks, 2).paddedLeft(' ', 10);
+}
+
+static void runProcessBlockBenchmarks(bool quick, int numBlocks, int oversamplingOrder, bool dynamic, int extraBands, int workers, const juce::String& filter) {
+    const std::vector<int> blockSizes = quick ? std::vector<int>{ 64, 512 } : std::vector<int>{ 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+    const std::vector<double> sampleRates = quick ? std::vector<double>{ 48000.0 } : std::vector<double>{ 44100.0, 48000.0, 96000.0, 192000.0 };
+    const std::vector<Slope> slopes = quick ? std::vector<Slope>{ Slope_12dB, Slope_48dB } : std::vector<Slope>{ Slope_12dB, Slope_24dB, Slope_36dB, Slope_48dB };
+    const std::vector<int> channelCounts = quick ? std::vector<int>{ 2 } : std::vector<int>{ 1, 2, 12, 16, 64 };
+
+    std::cout << "processBlock\n"
+              << "case                                       ns/smp  p50(us)   p90(us)   p99(us)   max(us)  allocs/blk\n";
+
+    for (const bool automated : { false, true })
+        for (const int numChannels : channelCounts)
+            for (const double sampleRate : sampleRates)
+                for (const Slope slope : slopes)
+                    for (const int blockSize : blockSizes) {
+                        const juce::String name = juce::String(numChannels) + "ch " + juce::String(sampleRate / 1000.0, 1) + "kHz "
+                                                + juce::String(12 * (slope + 1)) + "dB bs" + juce::String(blockSize)
+                                                + (oversamplingOrder > 0 ? " os" + juce::String(1 << oversamplingOrder) + "x" : juce::String())
+                                                + (dynamic ? " dynamic" : "")
+                                                + (extraBands > 0 ? " +" + juce::String(extraBands) + "bands" : juce::String())
+                                                + (workers > 0 ? " " + juce::String(workers) + "workers" : juce::String())
+                                                + (automated ? " automated" : "");
+
+                        if (filter.isNotEmpty() && !name.containsIgnoreCase(filter))
+                            continue;
+
+                        const ProcessBlockCase testCase{ blockSize, sampleRate, slope, numChannels, automated, oversamplingOrder, dynamic, extraBands, workers };
+                        std::cout << name.paddedRight(' ', 40) << runProcessBlockCase(testCase, numBlocks) << "\n" << std::flush;
+                    }
+}
+
+//==============================================================================
+template <typename Function>
+static juce::String measureDesign(int iterations, Function&& design) {
+    std::vector<double> times;
+    times.reserve(static_cast<size_t>(iterations));
+    juce::int64 totalAllocations = 0;
+
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+        ScopedAllocationCounter counter;
+        const Clock::time_point start = Clock::now();
+        design(iteration);
+        times.push_back(nanosecondsSince(start));
+        totalAllocations += counter.getCount();
+    }
+
+    const Percentiles percentiles = computePercentiles(times);
+
+    return juce::String(percentiles.mean, 1).paddedLeft(' ', 10)
+         + juce::String(percentiles.p50, 1).paddedLeft(' ', 10)
+         + juce::String(percentiles.p90, 1).paddedLeft(' ', 10)
+         + juce::String(percentiles.p99, 1).paddedLeft(' ', 10)
+         + juce::String(percentiles.max, 1).paddedLeft(' ', 10)
+         + juce::String(static_cast<double>(totalAllocations) / iterations, 2).paddedLeft(' ', 10);
+}
+
+static void runDesignBenchmarks(int iterations, bool tableMode, const juce::String& filter) {
+    std::cout << "\nfilter design\n"
+              << "case                                      mean(ns)   p50(ns)   p90(ns)   p99(ns)   max(ns)  allocs/call\n";
+
+    const double sampleRate = 48000.0;
+
+    // Sweeps the frequency so no call sees exactly the previous arguments.
+    auto sweep = [](int iteration, float low, float high) {
+        return low + (high - low) * static_cast<float>(iteration % 1000) / 999.0f;
+    };
+
+    auto report = [&filter](const juce::String& name, const juce::String& result) {
+        if (filter.isEmpty() || name.containsIgnoreCase(filter))
+            std::cout << name.paddedRight(' ', 40) << result << "\n" << std::flush;
+    };
+
+    report("makePeakFilters", measureDesign(iterations, [&](int iteration) {
+        ChainSettings settings;
+        settings.peak1Frequency = sweep(iteration, 500.0f, 5000.0f);
+        settings.peak1GainInDecibels = 6.0f;
+        auto [peak1, peak2] = makePeakFilters(settings, sampleRate);
+        benchmarkSink = peak1->coefficients[0] + peak2->coefficients[0];
+    }));
+
+    for (const Slope slope : { Slope_12dB, Slope_24dB, Slope_36dB, Slope_48dB }) {
+        const juce::String suffix = " " + juce::String(12 * (slope + 1)) + "dB";
+
+        report("makeLowCutFilter" + suffix, measureDesign(iterations, [&](int iteration) {
+            ChainSettings settings;
+            settings.lowCutFrequency = sweep(iteration, 20.0f, 500.0f);
+            settings.lowCutSlope = slope;
+            auto coefficients = makeLowCutFilter(settings, sampleRate);
+            benchmarkSink = coefficients.getFirst()->coefficients[0];
+        }));
+
+        report("makeHighCutFilter" + suffix, measureDesign(iterations, [&](int iteration) {
+            ChainSettings settings;
+            settings.highCutFrequency = sweep(iteration, 2000.0f, 20000.0f);
+            settings.highCutSlope = slope;
+            auto coefficients = makeHighCutFilter(settings, sampleRate);
+            benchmarkSink = coefficients.getFirst()->coefficients[0];
+        }));
+
+        report("makeLowCutBand (closed form)" + suffix, measureDesign(iterations, [&](int iteration) {
+            BandCoefficients band;
+            makeLowCutBand(band, sampleRate, sweep(iteration, 20.0f, 500.0f), slope);
+            benchmarkSink = band.sections[0].b0;
+        }));
+    }
+
+    report("makePeakBiquad (closed form)", measureDesign(iterations, [&](int iteration) {
+        benchmarkSink = makePeakBiquad(sampleRate, sweep(iteration, 500.0f, 5000.0f), 1.0f, 2.0f).b0;
+    }));
+
+    report("designEQCoefficients", measureDesign(iterations, [&](int iteration) {
+        ChainSettings settings;
+        settings.peak1Frequency = sweep(iteration, 500.0f, 5000.0f);
+        settings.lowCutSlope = Slope_48dB;
+        settings.highCutSlope = Slope_48dB;
+        benchmarkSink = designEQCoefficients(settings, sampleRate).bands[0].sections[0].b0;
+    }));
+
+    // The sweep repeats every 1000 iterations, so after the first pass these
+    // are mostly cache hits, as during a repeated automation sweep.
+    juce::SharedResourcePointer<CoefficientCache> cache;
+    cache->setTableModeEnabled(tableMode);
+    cache->prepareTable(sampleRate);
+
+    report(juce::String("designEQCoefficients (cached") + (tableMode ? ", table)" : ")"), measureDesign(iterations, [&](int iteration) {
+        ChainSettings settings;
+        settings.peak1Frequency = sweep(iteration, 500.0f, 5000.0f);
+        settings.lowCutSlope = Slope_48dB;
+        settings.highCutSlope = Slope_48dB;
+        benchmarkSink = designEQCoefficients(settings, sampleRate, cache).bands[0].sections[0].b0;
+    }));
+
+    std::cout << "coefficient cache: " << cache->getNumEntries() << " of " << CoefficientCache::capacity << " slots filled\n";
+}
+
+//==============================================================================
+int main(int argc, char* argv[]) {
+    const juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h")) {
+        std::cout << "Usage: Benchmark [--quick] [--blocks <n>] [--iterations <n>] [--filter <text>] [--oversampling <0-3>] [--dynamic] [--extra-bands <0-20>] [--table-mode] [--no-design] [--no-process] [--kernels <scalar|avx2|avx512>] [--workers <0-16>]\n";
+        return 0;
+    }
+
+    if (args.containsOption("--kernels")) {
+        const int variant = DSPKernels::findVariant(args.getValueForOption("--kernels"));
+
+        if (variant < 0 || DSPKernels::get(static_cast<DSPKernels::Variant>(variant)) == nullptr) {
+            std::cerr << "Kernels " << args.getValueForOption("--kernels") << " aren't in this build or can't run on this CPU\n";
+            return 1;
+        }
+
+        DSPKernels::setForcedVariant(variant);
+    }
+
+    // AudioProcessorValueTreeState needs a message manager for its timer.
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const bool quick = args.containsOption("--quick");
+    const int numBlocks = args.containsOption("--blocks") ? juce::jmax(1, args.getValueForOption("--blocks").getIntValue()) : (quick ? 500 : 2000);
+    const int iterations = args.containsOption("--iterations") ? juce::jmax(1, args.getValueForOption("--iterations").getIntValue()) : 20000;
+    const juce::String filter = args.getValueForOption("--filter");
+    const int oversamplingOrder = juce::jlimit(0, EQEngine::maxOversamplingOrder, args.getValueForOption("--oversampling").getIntValue());
+    const int extraBands = juce::jlimit(0, numExtraBands, args.getValueForOption("--extra-bands").getIntValue());
+    const int workers = juce::jlimit(0, EqualizerAudioProcessor::maxParallelWorkers, args.getValueForOption("--workers").getIntValue());
+
+    std::cout << juce::SystemStats::getJUCEVersion() << ", " << juce::SystemStats::getCpuModel() << ", "
+              << EQEngine::laneWidth << " SIMD lanes, " << DSPKernels::select().name << " kernels\n\n";
+
+    if (!args.containsOption("--no-process"))
+        runProcessBlockBenchmarks(quick, numBlocks, oversamplingOrder, args.containsOption("--dynamic"), extraBands, workers, filter);
+
+    if (!args.containsOption("--no-design"))
+        runDesignBenchmarks(iterations, args.containsOption("--table-mode"), filter);
+
+    return 0;
+}
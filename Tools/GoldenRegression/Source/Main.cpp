@@ -0,0 +1,1116 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+
+    Golden-reference regression harness. Renders an impulse, a sweep and
+    noise through the EQ for a matrix of settings (every slope, band and
+    parameter extremes, oversampling, stereo placement) at 44.1-192 kHz.
+    --record stores a compact golden file from a reference built only from
+    JUCE's own filter designs and dsp::IIR::Filter, as the ChannelEQ
+    ProcessorChain ran them; --compare renders the plugin's paths and
+    alternatives to them and checks them against it with ULP and dB
+    tolerances, after checking the closed-form and cached cut designs
+    against JUCE's coefficient by coefficient. Cases run in parallel on a
+    work-stealing pool, so a full pass is quick enough to gate a build.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../../Source/BiquadCascade.h"
+#include "../../../Source/ChainSettings.h"
+#include "../../../Source/CoefficientCache.h"
+#include "../../../Source/DSPKernels.h"
+#include "../../../Source/EQCoefficients.h"
+#include "../../../Source/EQEngine.h"
+#include "../../../Source/WorkStealingPool.h"
+
+//==============================================================================
+// Every signal is this long; the golden file keeps the first goldenHead
+// samples, where design and state errors show up first, and goldenStride
+// spread evenly over the rest.
+constexpr int signalLength = 8192;
+constexpr int goldenHead = 256;
+constexpr int goldenStride = 256;
+constexpr int goldenPoints = goldenHead + goldenStride;
+constexpr int renderBlockSize = 512;
+
+static const juce::uint32 goldenMagic = juce::ByteOrder::littleEndianInt("EQGR");
+constexpr int goldenVersion = 2;
+
+enum Signal {
+    Impulse,
+    Sweep,
+    Noise,
+    numSignals
+};
+
+static const char* const signalNames[numSignals] = { "impulse", "sweep", "noise" };
+
+struct Case {
+    juce::String name;
+    ChainSettings settings;
+    double sampleRate{ 44100.0 };
+    int numChannels{ 1 };
+};
+
+// What one output channel of one signal is compared on. The noise is how far
+// the reference's own float rounding moves it: rendered again with the input
+// scaled by 3, 5 and 7 and the output scaled back, the worst error energy and
+// the largest single difference from the golden points.
+struct GoldenOutput {
+    juce::uint64 hash{ 0 };
+    std::array<float, goldenPoints> points{};
+    float noiseDb{ -3000.0f };
+    float noisePeak{ 0.0f };
+};
+
+struct GoldenCase {
+    int numChannels{ 0 };
+    std::array<std::vector<GoldenOutput>, numSignals> outputs;
+};
+
+// A sample fails when it is more than maxUlps away from the golden value and
+// further than floorDb (relative to the output's peak) from it, so ULPs near
+// zero crossings don't count. A whole output fails when its error energy
+// relative to the golden one is above maxErrorDb. maxUlps < 0 skips the
+// per-sample check.
+//
+// Paths that round differently from the reference, e.g. with double state or
+// fused multiply-adds, also get noiseMarginDb over the golden output's
+// rounding noise, on both the floor and the error energy. A low cut near
+// 20 Hz has its poles so close to z = 1 that any other rounding of it is
+// tens of dB away; the margin lets that through without loosening the
+// well-conditioned cases, whose noise is far below the fixed limits.
+struct Tolerance {
+    int maxUlps{ 0 };
+    double floorDb{ -100.0 };
+    double maxErrorDb{ -100.0 };
+    double noiseMarginDb{ -std::numeric_limits<double>::infinity() };
+};
+
+// In standalone tests, double state lands within 6 dB of the reference's
+// rounding noise and fused multiply-adds within 12 dB.
+constexpr double roundingNoiseMarginDb = 20.0;
+
+// What every path but the reference is held to, whatever kernels it runs.
+constexpr Tolerance floatTolerance{ 4, -120.0, -120.0, roundingNoiseMarginDb };
+
+struct CaseResult {
+    bool supported{ true };
+    bool bitExact{ true };
+    bool passed{ true };
+    juce::int64 worstUlps{ 0 };
+    double worstErrorDb{ -std::numeric_limits<double>::infinity() };
+    juce::String detail;
+};
+
+static void printUsage() {
+    std::cout << "Usage: GoldenRegression --record <golden file> [options]\n"
+                 "       GoldenRegression --compare <golden file> [options]\n"
+                 "       GoldenRegression --designs [--verbose]\n"
+                 "\n"
+                 "Options:\n"
+                 "  --path <name>      Path to compare: reference, engine, cached, scalar, double or all (default: all)\n"
+                 "  --ulps <n>         Max ULPs per sample, -1 to skip the check (default: per path)\n"
+                 "  --floor <dB>       Differences this far below the output's peak always pass (default: per path)\n"
+                 "  --db <dB>          Max error energy relative to the golden output (default: per path)\n"
+                 "  --noise <dB>       Margin over the reference's own rounding noise (default: per path)\n"
+                 "  --filter <text>    Only cases whose name contains the text\n"
+                 "  --jobs <n>         Worker threads (default: number of CPU cores)\n"
+                 "  --kernels <name>   Compare with scalar, avx2 or avx512 kernels (default: the best this CPU runs)\n"
+                 "  --verbose          List every case, not just the failures\n"
+                 "\n"
+                 "The golden file comes from the reference path; compare against it after changing a DSP path.\n"
+                 "--compare first checks the closed-form and cached cut designs against JUCE's; --designs runs only that check.\n"
+                 "Recording always uses the scalar kernels, which the reference only runs for oversampled cases.\n";
+}
+
+//==============================================================================
+static juce::String getSlopeName(Slope slope) {
+    return juce::String(12 * (static_cast<int>(slope) + 1)) + "dB";
+}
+
+static juce::String getTypeName(BandType type) {
+    static const char* const names[] = { "low shelf", "high shelf", "bell", "notch" };
+    return names[juce::jlimit(0, 3, static_cast<int>(type))];
+}
+
+// Cuts parked at the edges of the audio range and flat peaks: nothing is designed.
+static ChainSettings makeFlatSettings() {
+    ChainSettings settings;
+    settings.lowCutFrequency = lowCutOffFrequency;
+    settings.highCutFrequency = highCutOffFrequency;
+    settings.peak1GainInDecibels = 0.0f;
+    settings.peak2GainInDecibels = 0.0f;
+    return settings;
+}
+
+static ChainSettings makeAllBandsSettings() {
+    ChainSettings settings = makeFlatSettings();
+    settings.lowCutFrequency = 30.0f;
+    settings.lowCutSlope = Slope_48dB;
+    settings.highCutFrequency = 16000.0f;
+    settings.highCutSlope = Slope_48dB;
+    settings.peak1GainInDecibels = 6.0f;
+    settings.peak2GainInDecibels = -6.0f;
+
+    for (int index = 0; index < numExtraBands; ++index) {
+        BandSettings& band = settings.extraBands[static_cast<size_t>(index)];
+        band.enabled = true;
+        band.type = static_cast<BandType>(index % 4);
+        band.frequency = CoefficientCache::quantiseFrequency(25.0f * std::pow(700.0f, (static_cast<float>(index) + 0.5f) / static_cast<float>(numExtraBands)));
+        band.gainInDecibels = index % 2 == 0 ? 4.5f : -4.5f;
+        band.quality = index % 3 == 0 ? 0.5f : 2.0f;
+    }
+
+    return settings;
+}
+
+static std::vector<Case> makeMatrix(const juce::String& filter) {
+    std::vector<std::pair<juce::String, ChainSettings>> settings;
+    std::vector<std::pair<juce::String, ChainSettings>> stereoSettings;
+
+    settings.emplace_back("flat", makeFlatSettings());
+
+    for (const float gain : { 24.0f, -24.0f }) {
+        ChainSettings output = makeFlatSettings();
+        output.outputGain = gain;
+        settings.emplace_back("output " + juce::String(gain, 0) + "dB", output);
+    }
+
+    // Every slope at both ends of each cut's range; the outer ends are
+    // nudged inside, as exactly on the edge the cut is designed as off.
+    for (int slope = Slope_12dB; slope <= Slope_48dB; ++slope) {
+        for (const float frequency : { 21.0f, 500.0f }) {
+            ChainSettings cut = makeFlatSettings();
+            cut.lowCutFrequency = frequency;
+            cut.lowCutSlope = static_cast<Slope>(slope);
+            settings.emplace_back("low cut " + getSlopeName(cut.lowCutSlope) + " " + juce::String(frequency, 0) + "Hz", cut);
+        }
+
+        for (const float frequency : { 2000.0f, 19900.0f }) {
+            ChainSettings cut = makeFlatSettings();
+            cut.highCutFrequency = frequency;
+            cut.highCutSlope = static_cast<Slope>(slope);
+            settings.emplace_back("high cut " + getSlopeName(cut.highCutSlope) + " " + juce::String(frequency, 0) + "Hz", cut);
+        }
+    }
+
+    for (int type = LowShelf; type <= Notch; ++type) {
+        const BandType bandType = static_cast<BandType>(type);
+
+        ChainSettings low = makeFlatSettings();
+        low.peak1Type = bandType;
+        low.peak1Frequency = 500.0f;
+        low.peak1GainInDecibels = 18.0f;
+        low.peak1Quality = 5.0f;
+        settings.emplace_back("peak 1 " + getTypeName(bandType) + " 500Hz +18dB Q5", low);
+
+        ChainSettings high = makeFlatSettings();
+        high.peak1Type = bandType;
+        high.peak1Frequency = 5000.0f;
+        high.peak1GainInDecibels = -18.0f;
+        high.peak1Quality = 0.5f;
+        settings.emplace_back("peak 1 " + getTypeName(bandType) + " 5000Hz -18dB Q0.5", high);
+
+        ChainSettings peak2 = makeFlatSettings();
+        peak2.peak2Type = bandType;
+        peak2.peak2Frequency = 10000.0f;
+        peak2.peak2GainInDecibels = 18.0f;
+        peak2.peak2Quality = 0.5f;
+        settings.emplace_back("peak 2 " + getTypeName(bandType) + " 10000Hz +18dB Q0.5", peak2);
+
+        ChainSettings bottom = makeFlatSettings();
+        bottom.extraBands[0] = { true, bandType, 20.0f, 24.0f, 0.1f };
+        settings.emplace_back("band 5 " + getTypeName(bandType) + " 20Hz +24dB Q0.1", bottom);
+
+        ChainSettings top = makeFlatSettings();
+        top.extraBands[1] = { true, bandType, 20000.0f, -24.0f, 10.0f };
+        settings.emplace_back("band 6 " + getTypeName(bandType) + " 20000Hz -24dB Q10", top);
+    }
+
+    settings.emplace_back("all bands", makeAllBandsSettings());
+
+    for (int order = 1; order <= EQEngine::maxOversamplingOrder; ++order) {
+        ChainSettings oversampled = makeAllBandsSettings();
+        oversampled.oversamplingOrder = order;
+        settings.emplace_back("all bands " + juce::String(1 << order) + "x", oversampled);
+    }
+
+    {
+        ChainSettings midSide = makeFlatSettings();
+        midSide.stereoMode = MidSide;
+        midSide.lowCutFrequency = 150.0f;
+        midSide.lowCutSlope = Slope_48dB;
+        midSide.placements[LowCut] = SecondChannel;
+        midSide.peak1Frequency = 1000.0f;
+        midSide.peak1GainInDecibels = 6.0f;
+        midSide.placements[PeakBand1] = FirstChannel;
+        stereoSettings.emplace_back("mid/side side low cut, mid bell", midSide);
+
+        ChainSettings leftRight = makeFlatSettings();
+        leftRight.peak1GainInDecibels = 12.0f;
+        leftRight.placements[PeakBand1] = FirstChannel;
+        leftRight.peak2GainInDecibels = -12.0f;
+        leftRight.placements[PeakBand2] = SecondChannel;
+        leftRight.outputGain = -3.0f;
+        stereoSettings.emplace_back("left/right split peaks", leftRight);
+    }
+
+    std::vector<Case> cases;
+
+    for (const double sampleRate : { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 }) {
+        auto add = [&](const std::pair<juce::String, ChainSettings>& entry, int numChannels) {
+            Case matrixCase{ entry.first + " @ " + juce::String(sampleRate, 0), entry.second, sampleRate, numChannels };
+            if (filter.isEmpty() || matrixCase.name.containsIgnoreCase(filter))
+                cases.push_back(matrixCase);
+        };
+
+        for (const auto& entry : settings)
+            add(entry, 1);
+
+        for (const auto& entry : stereoSettings)
+            add(entry, 2);
+    }
+
+    return cases;
+}
+
+//==============================================================================
+// Coefficient checks. A wrong design shows up here by name, before any audio
+// is rendered. Frequencies sit on the cache's 0.1 Hz grid, so quantising
+// them changes nothing.
+constexpr double designRates[] = { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+constexpr int designFrequencies = 64;
+constexpr double maxDesignError = 1.0e-5;     // see getDesignError
+
+struct DesignCheck {
+    int compared{ 0 }, failed{ 0 };
+    double worstError{ 0.0 };
+    juce::String worstCase;
+};
+
+static float getDesignFrequency(int index) {
+    const float frequency = 20.5f * std::pow(19999.0f / 20.5f, static_cast<float>(index) / static_cast<float>(designFrequencies - 1));
+    return CoefficientCache::quantiseFrequency(frequency);
+}
+
+// Numerator errors relative to the largest numerator coefficient, so a
+// cut's tiny gain doesn't hide them; denominator errors relative to a0 == 1,
+// so a coefficient that happens to be near zero doesn't blow them up.
+static double getDesignError(const BiquadCoefficients& actual, const BiquadCoefficients& expected) {
+    const double numeratorScale = juce::jmax(1.0e-30, static_cast<double>(juce::jmax(std::abs(expected.b0), std::abs(expected.b1), std::abs(expected.b2))));
+
+    auto difference = [](float a, float e) {
+        const double result = std::abs(static_cast<double>(a) - static_cast<double>(e));
+        return std::isfinite(result) ? result : std::numeric_limits<double>::infinity();
+    };
+
+    return juce::jmax(difference(actual.b0, expected.b0) / numeratorScale,
+                      difference(actual.b1, expected.b1) / numeratorScale,
+                      difference(actual.b2, expected.b2) / numeratorScale,
+                      juce::jmax(difference(actual.a1, expected.a1), difference(actual.a2, expected.a2)));
+}
+
+static void checkBand(const BandCoefficients& actual, const BandCoefficients& expected, const juce::String& name, bool verbose,
+                      DesignCheck& check) {
+    double error = actual.numSections == expected.numSections ? 0.0 : std::numeric_limits<double>::infinity();
+
+    for (int stage = 0; stage < juce::jmin(actual.numSections, expected.numSections); ++stage)
+        error = juce::jmax(error, getDesignError(actual.sections[static_cast<size_t>(stage)], expected.sections[static_cast<size_t>(stage)]));
+
+    ++check.compared;
+
+    if (check.worstCase.isEmpty() || error > check.worstError) {
+        check.worstError = error;
+        check.worstCase = name;
+    }
+
+    if (error > maxDesignError) {
+        ++check.failed;
+        std::cout << "  FAIL  " << name << "  (" << actual.numSections << " sections, expected " << expected.numSections
+                  << ", relative error " << error << ")\n";
+    }
+    else if (verbose) {
+        std::cout << "  pass  " << name << "\n";
+    }
+}
+
+static BandCoefficients toBandCoefficients(const juce::ReferenceCountedArray<juce::dsp::IIR::Coefficients<float>>& designs) {
+    BandCoefficients band;
+    band.numSections = juce::jmin(designs.size(), BandCoefficients::maxSections);
+
+    for (int stage = 0; stage < band.numSections; ++stage)
+        band.sections[static_cast<size_t>(stage)] = toBiquadCoefficients(*designs.getObjectPointerUnchecked(stage));
+
+    return band;
+}
+
+// makeLowCutBand and makeHighCutBand against the FilterDesign cascades they replace.
+static void checkClosedFormCuts(bool verbose, DesignCheck& check) {
+    for (const double sampleRate : designRates) {
+        for (int slope = Slope_12dB; slope <= Slope_48dB; ++slope) {
+            const int order = 2 * (slope + 1);
+
+            for (int index = 0; index < designFrequencies; ++index) {
+                const float frequency = getDesignFrequency(index);
+                const juce::String suffix = " " + getSlopeName(static_cast<Slope>(slope)) + " " + juce::String(frequency, 1) + "Hz @ " + juce::String(sampleRate, 0);
+                BandCoefficients band;
+
+                makeLowCutBand(band, sampleRate, frequency, static_cast<Slope>(slope));
+                checkBand(band, toBandCoefficients(juce::dsp::FilterDesign<float>::designIIRHighpassHighOrderButterworthMethod(frequency, sampleRate, order)),
+                          "closed-form low cut" + suffix, verbose, check);
+
+                makeHighCutBand(band, sampleRate, frequency, static_cast<Slope>(slope));
+                checkBand(band, toBandCoefficients(juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod(frequency, sampleRate, order)),
+                          "closed-form high cut" + suffix, verbose, check);
+            }
+        }
+    }
+}
+
+// Both cuts as designEQCoefficients makes them through a coefficient cache
+// (a miss, then a hit, then a miss served from the angle table) against the
+// uncached designs, which come straight from FilterDesign.
+static void checkCachedCuts(bool verbose, DesignCheck& check) {
+    for (const double sampleRate : designRates) {
+        CoefficientCache cache, tableCache;
+        tableCache.setTableModeEnabled(true);
+        tableCache.prepareTable(sampleRate);
+
+        for (int slope = Slope_12dB; slope <= Slope_48dB; ++slope) {
+            for (int index = 0; index < designFrequencies; ++index) {
+                ChainSettings settings = makeFlatSettings();
+                settings.lowCutFrequency = settings.highCutFrequency = getDesignFrequency(index);
+                settings.lowCutSlope = settings.highCutSlope = static_cast<Slope>(slope);
+
+                const juce::String suffix = " " + getSlopeName(settings.lowCutSlope) + " " + juce::String(settings.lowCutFrequency, 1) + "Hz @ " + juce::String(sampleRate, 0);
+                const EQCoefficients expected = designEQCoefficients(settings, sampleRate);
+
+                const std::pair<const char*, CoefficientCache*> passes[] = { { "cached", &cache }, { "cache hit", &cache }, { "table", &tableCache } };
+
+                for (const auto& pass : passes) {
+                    const EQCoefficients actual = designEQCoefficients(settings, sampleRate, pass.second);
+                    checkBand(actual.bands[ChainPositions::LowCut], expected.bands[ChainPositions::LowCut], juce::String(pass.first) + " low cut" + suffix, verbose, check);
+                    checkBand(actual.bands[ChainPositions::HighCut], expected.bands[ChainPositions::HighCut], juce::String(pass.first) + " high cut" + suffix, verbose, check);
+                }
+            }
+        }
+    }
+}
+
+static bool checkDesigns(bool verbose) {
+    DesignCheck check;
+    checkClosedFormCuts(verbose, check);
+    checkCachedCuts(verbose, check);
+
+    std::cout << "designs: " << check.compared << " bands, " << check.failed << " failed, worst relative error "
+              << check.worstError << " (" << check.worstCase << ")\n";
+    return check.failed == 0;
+}
+
+//==============================================================================
+// Channel 1 of a stereo case carries an inverted, halved copy, so mid and
+// side both have content.
+static juce::AudioBuffer<float> makeSignal(Signal signal, double sampleRate, int numChannels) {
+    juce::AudioBuffer<float> buffer(numChannels, signalLength);
+    buffer.clear();
+    float* samples = buffer.getWritePointer(0);
+
+    switch (signal) {
+        case Impulse:
+            samples[0] = 1.0f;
+            break;
+
+        case Sweep: {
+            // Exponential sweep from 20 Hz to 0.45 of the sample rate.
+            const double duration = signalLength / sampleRate;
+            const double startFrequency = 20.0, endFrequency = 0.45 * sampleRate;
+            const double rate = std::log(endFrequency / startFrequency);
+
+            for (int sample = 0; sample < signalLength; ++sample) {
+                const double time = sample / sampleRate;
+                const double phase = juce::MathConstants<double>::twoPi * startFrequency * duration / rate * (std::exp(time * rate / duration) - 1.0);
+                samples[sample] = static_cast<float>(0.5 * std::sin(phase));
+            }
+            break;
+        }
+
+        case Noise:
+        default: {
+            juce::Random random(0x5eed);
+            for (int sample = 0; sample < signalLength; ++sample)
+                samples[sample] = random.nextFloat() - 0.5f;
+            break;
+        }
+    }
+
+    for (int channel = 1; channel < numChannels; ++channel)
+        buffer.copyFrom(channel, 0, buffer, 0, 0, signalLength, -0.5f);
+
+    return buffer;
+}
+
+static juce::uint64 hashSamples(const float* samples, int numSamples) {
+    // FNV-1a over the raw bits, so -0.0 and NaN payloads count as changes too.
+    juce::uint64 hash = 0xcbf29ce484222325ull;
+    const juce::uint8* bytes = reinterpret_cast<const juce::uint8*>(samples);
+
+    for (size_t index = 0; index < static_cast<size_t>(numSamples) * sizeof(float); ++index)
+        hash = (hash ^ bytes[index]) * 0x100000001b3ull;
+
+    return hash;
+}
+
+static int getGoldenIndex(int point) {
+    if (point < goldenHead)
+        return point;
+
+    return goldenHead + (point - goldenHead) * ((signalLength - goldenHead) / goldenStride);
+}
+
+static GoldenOutput makeGoldenOutput(const float* samples) {
+    GoldenOutput output;
+    output.hash = hashSamples(samples, signalLength);
+
+    for (int point = 0; point < goldenPoints; ++point)
+        output.points[static_cast<size_t>(point)] = samples[getGoldenIndex(point)];
+
+    return output;
+}
+
+//==============================================================================
+// Render paths. Each filters a buffer in place and returns false when it
+// can't handle the case, e.g. oversampling on a path without resamplers.
+using RenderFunction = std::function<bool(const Case&, juce::AudioBuffer<float>&)>;
+
+struct RenderPath {
+    juce::String name;
+    juce::String description;
+    Tolerance tolerance;
+    RenderFunction render;
+};
+
+static bool renderWithEngine(const Case& matrixCase, juce::AudioBuffer<float>& buffer, CoefficientCache* cache) {
+    const ChainSettings& settings = matrixCase.settings;
+
+    EQEngine engine;
+    engine.prepare(matrixCase.sampleRate, renderBlockSize, matrixCase.numChannels);
+    engine.setOversamplingOrder(settings.oversamplingOrder);
+    engine.setCoefficients(designEQCoefficients(settings, getProcessingSampleRate(settings, matrixCase.sampleRate), cache));
+
+    const juce::dsp::AudioBlock<float> block(buffer);
+    for (int start = 0; start < signalLength; start += renderBlockSize)
+        engine.process(block.getSubBlock(static_cast<size_t>(start), static_cast<size_t>(juce::jmin(renderBlockSize, signalLength - start))));
+
+    return true;
+}
+
+static BiquadCoefficients withGain(BiquadCoefficients section, float gainFactor) {
+    section.b0 *= gainFactor;
+    section.b1 *= gainFactor;
+    section.b2 *= gainFactor;
+    return section;
+}
+
+// The sections one channel runs, in chain order, with the output gain folded
+// into the last one the way EQEngine does it.
+static int getChannelSections(const EQCoefficients& coefficients, int channel, bool split,
+                              std::array<BiquadCoefficients, EQCoefficients::maxTotalSections>& sections) {
+    int count = 0;
+
+    for (int index = 0; index < coefficients.numActiveBands; ++index) {
+        const int band = coefficients.activeBands[static_cast<size_t>(index)];
+        const BandPlacement placement = coefficients.settings.placements[static_cast<size_t>(band)];
+        const bool skipped = split && placement != BothChannels && (placement == SecondChannel) != (channel == 1);
+        const BandCoefficients& bandCoefficients = coefficients.bands[static_cast<size_t>(band)];
+
+        for (int stage = 0; stage < bandCoefficients.numSections; ++stage)
+            sections[static_cast<size_t>(count++)] = skipped ? BiquadCoefficients() : bandCoefficients.sections[static_cast<size_t>(stage)];
+    }
+
+    const float outputGain = juce::Decibels::decibelsToGain(coefficients.settings.outputGain);
+
+    if (count == 0 && outputGain != 1.0f)
+        sections[static_cast<size_t>(count++)] = BiquadCoefficients();
+
+    if (count > 0)
+        sections[static_cast<size_t>(count - 1)] = withGain(sections[static_cast<size_t>(count - 1)], outputGain);
+
+    return count;
+}
+
+static bool isSplitStereo(const EQCoefficients& coefficients, int numChannels) {
+    if (numChannels != 2)
+        return false;
+
+    for (int index = 0; index < coefficients.numActiveBands; ++index)
+        if (coefficients.settings.placements[static_cast<size_t>(coefficients.activeBands[static_cast<size_t>(index)])] != BothChannels)
+            return true;
+
+    return false;
+}
+
+// One channel at a time, section after section, in the given precision.
+// float runs BiquadCascade's scalar instantiation; double is a plain
+// transposed direct form II loop with double state.
+template <typename Sample>
+static bool renderDirect(const Case& matrixCase, juce::AudioBuffer<float>& buffer) {
+    const ChainSettings& settings = matrixCase.settings;
+    if (settings.oversamplingOrder != 0)
+        return false;
+
+    const EQCoefficients coefficients = designEQCoefficients(settings, matrixCase.sampleRate);
+    const bool split = isSplitStereo(coefficients, matrixCase.numChannels);
+    const bool midSide = split && settings.stereoMode == MidSide;
+
+    std::vector<std::vector<Sample>> channels(static_cast<size_t>(matrixCase.numChannels), std::vector<Sample>(signalLength));
+    for (int channel = 0; channel < matrixCase.numChannels; ++channel)
+        for (int sample = 0; sample < signalLength; ++sample)
+            channels[static_cast<size_t>(channel)][static_cast<size_t>(sample)] = static_cast<Sample>(buffer.getSample(channel, sample));
+
+    if (midSide) {
+        for (int sample = 0; sample < signalLength; ++sample) {
+            const Sample left = channels[0][static_cast<size_t>(sample)], right = channels[1][static_cast<size_t>(sample)];
+            channels[0][static_cast<size_t>(sample)] = static_cast<Sample>(0.5) * (left + right);
+            channels[1][static_cast<size_t>(sample)] = static_cast<Sample>(0.5) * (left - right);
+        }
+    }
+
+    for (int channel = 0; channel < matrixCase.numChannels; ++channel) {
+        std::array<BiquadCoefficients, EQCoefficients::maxTotalSections> sections;
+        const int count = getChannelSections(coefficients, channel, split, sections);
+        Sample* samples = channels[static_cast<size_t>(channel)].data();
+
+        if constexpr (std::is_same_v<Sample, float>) {
+            std::array<int, EQCoefficients::maxTotalSections> keys;
+            std::iota(keys.begin(), keys.end(), 0);
+
+            BiquadCascade<float> cascade;
+            cascade.setSections(sections.data(), keys.data(), count);
+            cascade.process(samples, signalLength);
+        }
+        else {
+            for (int index = 0; index < count; ++index) {
+                const BiquadCoefficients& section = sections[static_cast<size_t>(index)];
+                Sample z1 = 0, z2 = 0;
+
+                for (int sample = 0; sample < signalLength; ++sample) {
+                    const Sample x = samples[sample];
+                    const Sample y = x * section.b0 + z1;
+                    z1 = x * section.b1 - y * section.a1 + z2;
+                    z2 = x * section.b2 - y * section.a2;
+                    samples[sample] = y;
+                }
+            }
+        }
+    }
+
+    if (midSide) {
+        for (int sample = 0; sample < signalLength; ++sample) {
+            const Sample mid = channels[0][static_cast<size_t>(sample)], side = channels[1][static_cast<size_t>(sample)];
+            channels[0][static_cast<size_t>(sample)] = mid + side;
+            channels[1][static_cast<size_t>(sample)] = mid - side;
+        }
+    }
+
+    for (int channel = 0; channel < matrixCase.numChannels; ++channel)
+        for (int sample = 0; sample < signalLength; ++sample)
+            buffer.setSample(channel, sample, static_cast<float>(channels[static_cast<size_t>(channel)][static_cast<size_t>(sample)]));
+
+    return true;
+}
+
+using FilterCoefficients = juce::dsp::IIR::Coefficients<float>::Ptr;
+
+// The sections the reference runs, in chain order, each with its chain
+// position: FilterDesign's cascades for the cuts and IIR::Coefficients'
+// factories for the rest, skipping the bands the plugin skips.
+static std::vector<std::pair<int, FilterCoefficients>> getReferenceSections(const ChainSettings& settings, double sampleRate) {
+    std::vector<std::pair<int, FilterCoefficients>> sections;
+
+    for (int position = 0; position < maxBands; ++position) {
+        if (position == LowCut) {
+            if (settings.lowCutFrequency > lowCutOffFrequency)
+                for (auto* coefficients : makeLowCutFilter(settings, sampleRate))
+                    sections.emplace_back(position, FilterCoefficients(coefficients));
+        }
+        else if (position == HighCut) {
+            if (settings.highCutFrequency < juce::jmin(highCutOffFrequency, static_cast<float>(sampleRate * 0.5)))
+                for (auto* coefficients : makeHighCutFilter(settings, sampleRate))
+                    sections.emplace_back(position, FilterCoefficients(coefficients));
+        }
+        else {
+            const BandSettings band = getBandSettings(settings, position);
+            if (band.enabled && (band.type == Notch || band.gainInDecibels != 0.0f))
+                sections.emplace_back(position, makeBandFilter(band, sampleRate));
+        }
+    }
+
+    return sections;
+}
+
+// The golden reference. JUCE's designs, one dsp::IIR::Filter per section,
+// each run over a whole block before the next like ChannelEQ's
+// ProcessorChain ran them, then the output gain. Nothing here goes through
+// designEQCoefficients, the coefficient cache or EQEngine, except for
+// oversampled cases: the resamplers are the engine's own, so those fall back
+// to it with JUCE's designs.
+static bool renderReference(const Case& matrixCase, juce::AudioBuffer<float>& buffer) {
+    const ChainSettings& settings = matrixCase.settings;
+    if (settings.oversamplingOrder != 0)
+        return renderWithEngine(matrixCase, buffer, nullptr);
+
+    const std::vector<std::pair<int, FilterCoefficients>> sections = getReferenceSections(settings, matrixCase.sampleRate);
+
+    bool split = false;
+    if (matrixCase.numChannels == 2)
+        for (const auto& section : sections)
+            split = split || settings.placements[static_cast<size_t>(section.first)] != BothChannels;
+
+    const bool midSide = split && settings.stereoMode == MidSide;
+
+    std::array<juce::OwnedArray<juce::dsp::IIR::Filter<float>>, 2> filters;
+    for (int channel = 0; channel < matrixCase.numChannels; ++channel) {
+        for (const auto& section : sections) {
+            const BandPlacement placement = settings.placements[static_cast<size_t>(section.first)];
+            if (!split || placement == BothChannels || (placement == SecondChannel) == (channel == 1))
+                filters[static_cast<size_t>(channel)].add(new juce::dsp::IIR::Filter<float>(section.second));
+        }
+    }
+
+    if (midSide) {
+        float* left = buffer.getWritePointer(0);
+        float* right = buffer.getWritePointer(1);
+
+        for (int sample = 0; sample < signalLength; ++sample) {
+            const float mid = 0.5f * (left[sample] + right[sample]);
+            right[sample] = 0.5f * (left[sample] - right[sample]);
+            left[sample] = mid;
+        }
+    }
+
+    juce::dsp::AudioBlock<float> block(buffer);
+    for (int start = 0; start < signalLength; start += renderBlockSize) {
+        const juce::dsp::AudioBlock<float> subBlock = block.getSubBlock(static_cast<size_t>(start), static_cast<size_t>(juce::jmin(renderBlockSize, signalLength - start)));
+
+        for (int channel = 0; channel < matrixCase.numChannels; ++channel) {
+            juce::dsp::AudioBlock<float> channelBlock = subBlock.getSingleChannelBlock(static_cast<size_t>(channel));
+
+            for (juce::dsp::IIR::Filter<float>* filter : filters[static_cast<size_t>(channel)])
+                filter->process(juce::dsp::ProcessContextReplacing<float>(channelBlock));
+        }
+    }
+
+    if (midSide) {
+        float* left = buffer.getWritePointer(0);
+        float* right = buffer.getWritePointer(1);
+
+        for (int sample = 0; sample < signalLength; ++sample) {
+            const float mid = left[sample], side = right[sample];
+            left[sample] = mid + side;
+            right[sample] = mid - side;
+        }
+    }
+
+    buffer.applyGain(juce::Decibels::decibelsToGain(settings.outputGain));
+    return true;
+}
+
+// The reference comes first; --record stores it. Every other path rounds at
+// least a little differently from it (EQEngine folds the output gain into
+// the last section), so each gets the rounding-noise margin.
+static std::vector<RenderPath> makePaths(CoefficientCache& cache) {
+    return {
+        { "reference", "JUCE's filter designs through dsp::IIR::Filter, as ChannelEQ's ProcessorChain ran them", { 0, -200.0, -200.0 },
+          [](const Case& c, juce::AudioBuffer<float>& b) { return renderReference(c, b); } },
+        { "engine", "EQEngine, SIMD cascade, with JUCE's filter designs", floatTolerance,
+          [](const Case& c, juce::AudioBuffer<float>& b) { return renderWithEngine(c, b, nullptr); } },
+        { "cached", "EQEngine with closed-form designs from the coefficient cache, as the plugin runs it", floatTolerance,
+          [&cache](const Case& c, juce::AudioBuffer<float>& b) { return renderWithEngine(c, b, &cache); } },
+        { "scalar", "BiquadCascade<float>, one channel at a time", floatTolerance,
+          [](const Case& c, juce::AudioBuffer<float>& b) { return renderDirect<float>(c, b); } },
+        { "double", "Double-precision state, float coefficients", floatTolerance,
+          [](const Case& c, juce::AudioBuffer<float>& b) { return renderDirect<double>(c, b); } },
+    };
+}
+
+//==============================================================================
+static bool writeGolden(const juce::File& file, const std::vector<Case>& cases, const std::vector<GoldenCase>& golden) {
+    file.deleteFile();
+    std::unique_ptr<juce::FileOutputStream> fileStream(file.createOutputStream());
+    if (fileStream == nullptr)
+        return false;
+
+    juce::GZIPCompressorOutputStream stream(fileStream.release(), 9, true);
+    stream.writeInt(static_cast<int>(goldenMagic));
+    stream.writeInt(goldenVersion);
+    stream.writeInt(signalLength);
+    stream.writeInt(goldenPoints);
+    stream.writeInt(static_cast<int>(cases.size()));
+
+    for (size_t index = 0; index < cases.size(); ++index) {
+        stream.writeString(cases[index].name);
+        stream.writeInt(golden[index].numChannels);
+
+        for (const std::vector<GoldenOutput>& outputs : golden[index].outputs) {
+            for (const GoldenOutput& output : outputs) {
+                stream.writeInt64(static_cast<juce::int64>(output.hash));
+                stream.write(output.points.data(), sizeof(float) * output.points.size());
+                stream.writeFloat(output.noiseDb);
+                stream.writeFloat(output.noisePeak);
+            }
+        }
+    }
+
+    stream.flush();
+    return true;
+}
+
+static bool readGolden(const juce::File& file, std::map<juce::String, GoldenCase>& golden, juce::String& error) {
+    std::unique_ptr<juce::FileInputStream> fileStream(file.createInputStream());
+    if (fileStream == nullptr) {
+        error = "cannot read " + file.getFullPathName();
+        return false;
+    }
+
+    juce::GZIPDecompressorInputStream stream(fileStream.release(), true);
+
+    if (static_cast<juce::uint32>(stream.readInt()) != goldenMagic || stream.readInt() != goldenVersion) {
+        error = file.getFileName() + " isn't a golden file from this version";
+        return false;
+    }
+
+    if (stream.readInt() != signalLength || stream.readInt() != goldenPoints) {
+        error = file.getFileName() + " was recorded with different signal lengths";
+        return false;
+    }
+
+    const int numCases = stream.readInt();
+
+    for (int index = 0; index < numCases; ++index) {
+        if (stream.isExhausted()) {
+            error = file.getFileName() + " is truncated";
+            return false;
+        }
+
+        const juce::String name = stream.readString();
+        GoldenCase& goldenCase = golden[name];
+        goldenCase.numChannels = juce::jlimit(0, 2, stream.readInt());
+
+        for (std::vector<GoldenOutput>& outputs : goldenCase.outputs) {
+            outputs.resize(static_cast<size_t>(goldenCase.numChannels));
+
+            for (GoldenOutput& output : outputs) {
+                output.hash = static_cast<juce::uint64>(stream.readInt64());
+                stream.read(output.points.data(), static_cast<int>(sizeof(float) * output.points.size()));
+                output.noiseDb = stream.readFloat();
+                output.noisePeak = stream.readFloat();
+            }
+        }
+    }
+
+    return true;
+}
+
+//==============================================================================
+// Distance in representable floats; 0 for equal values, including +0 and -0.
+static juce::int64 getUlpDistance(float a, float b) {
+    auto ordered = [](float value) {
+        juce::int32 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits < 0 ? static_cast<juce::int64>(std::numeric_limits<juce::int32>::min()) - bits : static_cast<juce::int64>(bits);
+    };
+
+    return std::abs(ordered(a) - ordered(b));
+}
+
+// Against full scale when the golden output is silent.
+static double getErrorDb(double errorEnergy, double goldenEnergy) {
+    return 10.0 * std::log10(juce::jmax(1.0e-300, errorEnergy) / (goldenEnergy > 0.0 ? goldenEnergy : static_cast<double>(goldenPoints)));
+}
+
+static void compareOutput(const GoldenOutput& golden, const float* samples, const Tolerance& tolerance,
+                          const juce::String& label, CaseResult& result) {
+    if (hashSamples(samples, signalLength) == golden.hash)
+        return;
+
+    result.bitExact = false;
+
+    float peak = 0.0f;
+    for (const float point : golden.points)
+        peak = juce::jmax(peak, std::abs(point));
+
+    const double floor = juce::jmax(peak * std::pow(10.0, tolerance.floorDb / 20.0),
+                                    golden.noisePeak * std::pow(10.0, tolerance.noiseMarginDb / 20.0));
+    const double maxErrorDb = juce::jmax(tolerance.maxErrorDb, golden.noiseDb + tolerance.noiseMarginDb);
+    double errorEnergy = 0.0, goldenEnergy = 0.0;
+    int failedSamples = 0;
+
+    for (int point = 0; point < goldenPoints; ++point) {
+        const float expected = golden.points[static_cast<size_t>(point)];
+        const float actual = samples[getGoldenIndex(point)];
+        const double difference = static_cast<double>(actual) - static_cast<double>(expected);
+
+        errorEnergy += difference * difference;
+        goldenEnergy += static_cast<double>(expected) * expected;
+
+        // NaNs and infinities never pass.
+        if (!std::isfinite(actual) || std::abs(difference) > floor) {
+            const juce::int64 ulps = std::isfinite(actual) ? getUlpDistance(actual, expected) : std::numeric_limits<juce::int64>::max();
+            result.worstUlps = juce::jmax(result.worstUlps, ulps);
+
+            if (tolerance.maxUlps >= 0 && ulps > tolerance.maxUlps)
+                ++failedSamples;
+        }
+    }
+
+    const double errorDb = getErrorDb(errorEnergy, goldenEnergy);
+    result.worstErrorDb = juce::jmax(result.worstErrorDb, errorDb);
+
+    if (failedSamples > 0 || errorDb > maxErrorDb || !std::isfinite(errorDb)) {
+        result.passed = false;
+        result.detail << (result.detail.isEmpty() ? "" : "; ") << label << ": " << failedSamples << " samples over "
+                      << tolerance.maxUlps << " ULPs, error " << juce::String(errorDb, 1) << " dB (limit " << juce::String(maxErrorDb, 1) << " dB)";
+    }
+}
+
+static CaseResult compareCase(const Case& matrixCase, const GoldenCase* golden, const RenderPath& path, const Tolerance& tolerance) {
+    CaseResult result;
+
+    if (golden == nullptr || golden->numChannels != matrixCase.numChannels) {
+        result.passed = false;
+        result.bitExact = false;
+        result.detail = "not in the golden file";
+        return result;
+    }
+
+    for (int signal = 0; signal < numSignals; ++signal) {
+        juce::AudioBuffer<float> buffer = makeSignal(static_cast<Signal>(signal), matrixCase.sampleRate, matrixCase.numChannels);
+
+        if (!path.render(matrixCase, buffer)) {
+            result.supported = false;
+            return result;
+        }
+
+        for (int channel = 0; channel < matrixCase.numChannels; ++channel)
+            compareOutput(golden->outputs[static_cast<size_t>(signal)][static_cast<size_t>(channel)], buffer.getReadPointer(channel), tolerance,
+                          juce::String(signalNames[signal]) + (matrixCase.numChannels > 1 ? " ch" + juce::String(channel) : juce::String()), result);
+    }
+
+    return result;
+}
+
+//==============================================================================
+// Renders the reference again with the input scaled by 3, 5 and 7 and the
+// output scaled back, and keeps how far that lands from each golden output.
+static void measureNoise(const Case& matrixCase, Signal signal, const RenderPath& reference, std::vector<GoldenOutput>& outputs) {
+    for (const float scale : { 3.0f, 5.0f, 7.0f }) {
+        juce::AudioBuffer<float> buffer = makeSignal(signal, matrixCase.sampleRate, matrixCase.numChannels);
+        buffer.applyGain(scale);
+        reference.render(matrixCase, buffer);
+        buffer.applyGain(1.0f / scale);
+
+        for (int channel = 0; channel < matrixCase.numChannels; ++channel) {
+            GoldenOutput& output = outputs[static_cast<size_t>(channel)];
+            const float* samples = buffer.getReadPointer(channel);
+            double errorEnergy = 0.0, goldenEnergy = 0.0;
+
+            for (int point = 0; point < goldenPoints; ++point) {
+                const float expected = output.points[static_cast<size_t>(point)];
+                const double difference = static_cast<double>(samples[getGoldenIndex(point)]) - static_cast<double>(expected);
+
+                errorEnergy += difference * difference;
+                goldenEnergy += static_cast<double>(expected) * expected;
+                output.noisePeak = juce::jmax(output.noisePeak, static_cast<float>(std::abs(difference)));
+            }
+
+            output.noiseDb = juce::jmax(output.noiseDb, static_cast<float>(getErrorDb(errorEnergy, goldenEnergy)));
+        }
+    }
+}
+
+static int record(const juce::File& file, const std::vector<Case>& cases, const RenderPath& reference, int numWorkers) {
+    std::vector<GoldenCase> golden(cases.size());
+
+    {
+        WorkStealingPool pool(numWorkers, "Golden Render");
+
+        for (size_t index = 0; index < cases.size(); ++index) {
+            pool.submit([&cases, &golden, &reference, index] {
+                const Case& matrixCase = cases[index];
+                GoldenCase& goldenCase = golden[index];
+                goldenCase.numChannels = matrixCase.numChannels;
+
+                for (int signal = 0; signal < numSignals; ++signal) {
+                    juce::AudioBuffer<float> buffer = makeSignal(static_cast<Signal>(signal), matrixCase.sampleRate, matrixCase.numChannels);
+                    reference.render(matrixCase, buffer);
+
+                    for (int channel = 0; channel < matrixCase.numChannels; ++channel)
+                        goldenCase.outputs[static_cast<size_t>(signal)].push_back(makeGoldenOutput(buffer.getReadPointer(channel)));
+
+                    measureNoise(matrixCase, static_cast<Signal>(signal), reference, goldenCase.outputs[static_cast<size_t>(signal)]);
+                }
+            });
+        }
+
+        pool.waitForAll();
+    }
+
+    if (!writeGolden(file, cases, golden)) {
+        std::cerr << "Cannot write " << file.getFullPathName() << "\n";
+        return 2;
+    }
+
+    std::cout << "Recorded " << cases.size() << " cases from the " << reference.name << " path to " << file.getFullPathName()
+              << " (" << juce::File::descriptionOfSizeInBytes(file.getSize()) << ")\n";
+    return 0;
+}
+
+static bool compare(const std::vector<Case>& cases, const std::map<juce::String, GoldenCase>& golden, const RenderPath& path,
+                    const Tolerance& tolerance, int numWorkers, bool verbose) {
+    std::vector<CaseResult> results(cases.size());
+    const double startMs = juce::Time::getMillisecondCounterHiRes();
+
+    {
+        WorkStealingPool pool(numWorkers, "Golden Compare");
+
+        for (size_t index = 0; index < cases.size(); ++index) {
+            pool.submit([&, index] {
+                const auto found = golden.find(cases[index].name);
+                results[index] = compareCase(cases[index], found != golden.end() ? &found->second : nullptr, path, tolerance);
+            });
+        }
+
+        pool.waitForAll();
+    }
+
+    int compared = 0, bitExact = 0, failed = 0;
+    juce::int64 worstUlps = 0;
+    double worstErrorDb = -std::numeric_limits<double>::infinity();
+    juce::String worstCase;
+
+    for (size_t index = 0; index < cases.size(); ++index) {
+        const CaseResult& result = results[index];
+        if (!result.supported)
+            continue;
+
+        ++compared;
+        bitExact += result.bitExact ? 1 : 0;
+        failed += result.passed ? 0 : 1;
+        worstUlps = juce::jmax(worstUlps, result.worstUlps);
+
+        if (result.worstErrorDb > worstErrorDb) {
+            worstErrorDb = result.worstErrorDb;
+            worstCase = cases[index].name;
+        }
+
+        if (!result.passed || verbose)
+            std::cout << "  " << (result.passed ? (result.bitExact ? "exact " : "pass  ") : "FAIL  ") << cases[index].name
+                      << (result.detail.isNotEmpty() ? "  (" + result.detail + ")" : juce::String()) << "\n";
+    }
+
+    std::cout << path.name << ": " << compared << " cases, " << bitExact << " bit-exact, " << failed << " failed, "
+              << (static_cast<int>(cases.size()) - compared) << " skipped";
+
+    if (bitExact < compared)
+        std::cout << ", worst " << worstUlps << " ULPs above the floor, worst error " << juce::String(worstErrorDb, 1) << " dB (" << worstCase << ")";
+
+    std::cout << "  [" << juce::String((juce::Time::getMillisecondCounterHiRes() - startMs) / 1000.0, 2) << " s]\n";
+    return failed == 0;
+}
+
+//==============================================================================
+int main(int argc, char* argv[]) {
+    const juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h") || (!args.containsOption("--record") && !args.containsOption("--compare") && !args.containsOption("--designs"))) {
+        printUsage();
+        return args.containsOption("--help|-h") ? 0 : 2;
+    }
+
+    if (args.containsOption("--designs"))
+        return checkDesigns(args.containsOption("--verbose")) ? 0 : 1;
+
+    const int numWorkers = args.containsOption("--jobs") ? juce::jlimit(1, 256, args.getValueForOption("--jobs").getIntValue())
+                                                         : juce::SystemStats::getNumCpus();
+    const std::vector<Case> cases = makeMatrix(args.getValueForOption("--filter"));
+
+    if (cases.empty()) {
+        std::cerr << "No cases match the filter\n";
+        return 2;
+    }
+
+    CoefficientCache cache;
+    const std::vector<RenderPath> paths = makePaths(cache);
+
+    // The golden file always comes from the reference path. Oversampled
+    // cases run it through EQEngine's resamplers, so those use the portable
+    // kernels and don't depend on the recording CPU.
+    if (args.containsOption("--record")) {
+        DSPKernels::setForcedVariant(DSPKernels::Scalar);
+        return record(args.getFileForOption("--record"), cases, paths.front(), numWorkers);
+    }
+
+    if (args.containsOption("--kernels")) {
+        const int variant = DSPKernels::findVariant(args.getValueForOption("--kernels"));
+
+        if (variant < 0 || DSPKernels::get(static_cast<DSPKernels::Variant>(variant)) == nullptr) {
+            std::cerr << "Kernels " << args.getValueForOption("--kernels") << " aren't in this build or can't run on this CPU\n";
+            return 2;
+        }
+
+        DSPKernels::setForcedVariant(variant);
+    }
+
+    const DSPKernels& kernels = DSPKernels::select();
+
+    std::map<juce::String, GoldenCase> golden;
+    juce::String error;
+    if (!readGolden(args.getFileForOption("--compare"), golden, error)) {
+        std::cerr << error << "\n";
+        return 2;
+    }
+
+    const juce::String pathName = args.containsOption("--path") ? args.getValueForOption("--path") : juce::String("all");
+    bool allPassed = checkDesigns(args.containsOption("--verbose")), anyPath = false;
+
+    std::cout << cases.size() << " cases x " << numSignals << " signals, " << numWorkers << " workers, "
+              << kernels.name << " kernels\n";
+
+    for (const RenderPath& path : paths) {
+        if (pathName != "all" && pathName != path.name)
+            continue;
+
+        Tolerance tolerance = path.tolerance;
+
+        // The wider kernels fuse multiply-adds, so the reference's oversampled
+        // cases can't match the scalar recording bit for bit. They get the
+        // other paths' tolerance, ULP limit included: only samples buried
+        // in the recorded rounding noise are let off it.
+        if (kernels.variant != DSPKernels::Scalar && tolerance.maxUlps == 0)
+            tolerance = floatTolerance;
+
+        if (args.containsOption("--ulps"))
+            tolerance.maxUlps = args.getValueForOption("--ulps").getIntValue();
+        if (args.containsOption("--floor"))
+            tolerance.floorDb = args.getValueForOption("--floor").getDoubleValue();
+        if (args.containsOption("--db"))
+            tolerance.maxErrorDb = args.getValueForOption("--db").getDoubleValue();
+        if (args.containsOption("--noise"))
+            tolerance.noiseMarginDb = args.getValueForOption("--noise").getDoubleValue();
+
+        std::cout << "\n" << path.name << " - " << path.description << "\n";
+        allPassed = compare(cases, golden, path, tolerance, numWorkers, args.containsOption("--verbose")) && allPassed;
+        anyPath = true;
+    }
+
+    if (!anyPath) {
+        std::cerr << "Unknown path " << pathName << "\n";
+        return 2;
+    }
+
+    return allPassed ? 0 : 1;
+}
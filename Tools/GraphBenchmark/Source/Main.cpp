@@ -0,0 +1,331 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+
+    Hosts many EqualizerAudioProcessor instances in one AudioProcessorGraph,
+    wired like Equalizer.filtergraph (stereo source -> Equalizer -> output),
+    and reports how the session scales with the number of instances: the
+    time to create and prepare them, CPU load as a share of realtime, cost
+    per instance, how much of it the graph itself adds, and how much slower
+    a block runs when the caches have been flushed before it.
+
+    In series every instance feeds the next, as in a chain of inserts on one
+    track; in parallel every instance reads the input and they're summed at
+    the output, as with one insert on each of many tracks.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../../Source/PluginProcessor.h"
+
+//==============================================================================
+using Clock = std::chrono::steady_clock;
+
+static double nanosecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+struct Percentiles {
+    double mean{ 0 }, p50{ 0 }, p99{ 0 }, max{ 0 };
+};
+
+static Percentiles computePercentiles(std::vector<double>& values) {
+    Percentiles result;
+    if (values.empty())
+        return result;
+
+    std::sort(values.begin(), values.end());
+    auto at = [&values](double fraction) {
+        return values[juce::jmin(values.size() - 1, static_cast<size_t>(fraction * static_cast<double>(values.size())))];
+    };
+
+    result.mean = std::accumulate(values.begin(), values.end(), 0.0) / static_cast<double>(values.size());
+    result.p50 = at(0.5);
+    result.p99 = at(0.99);
+    result.max = values.back();
+    return result;
+}
+
+// Keeps the optimiser from discarding results it can prove unused.
+static volatile float benchmarkSink = 0.0f;
+
+//==============================================================================
+// Touches one byte per cache line of a buffer larger than the last-level
+// cache, so the next block finds none of the instances' state in cache, as
+// when other tracks and plugins have run in between.
+class CacheEvictor {
+public:
+    explicit CacheEvictor(size_t numBytes) : buffer(numBytes, 1) {}
+
+    bool isEnabled() const noexcept { return !buffer.empty(); }
+
+    void evict() noexcept {
+        unsigned char sum = 0;
+        for (size_t index = 0; index < buffer.size(); index += 64) {
+            buffer[index] = static_cast<unsigned char>(buffer[index] + 1);
+            sum = static_cast<unsigned char>(sum + buffer[index]);
+        }
+        benchmarkSink = static_cast<float>(sum);
+    }
+
+private:
+    std::vector<unsigned char> buffer;
+};
+
+//==============================================================================
+enum class Topology { Series, Parallel };
+
+struct GraphCase {
+    Topology topology;
+    int numInstances;
+    double sampleRate;
+    double seconds;         // audio processed per measurement
+    int program;            // -1 cycles through the non-default presets
+};
+
+struct BlockResult {
+    double prepareMs{ 0 };
+    Percentiles hot;
+    double pluginSeconds{ 0 };  // summed over the instances' own telemetry
+    double hotSeconds{ 0 };
+    double coldMean{ 0 };
+};
+
+static void fillWithNoise(juce::AudioBuffer<float>& buffer, juce::Random& random) {
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
+        float* samples = buffer.getWritePointer(channel);
+        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+            samples[sample] = random.nextFloat() * 0.5f - 0.25f;
+    }
+}
+
+class GraphSession {
+public:
+    using Graph = juce::AudioProcessorGraph;
+    using IOProcessor = Graph::AudioGraphIOProcessor;
+
+    explicit GraphSession(const GraphCase& testCase) {
+        graph.setPlayConfigDetails(2, 2, testCase.sampleRate, 512);
+
+        // Connections are added without rebuilding the render sequence each
+        // time; prepareToPlay builds it once.
+        input = graph.addNode(std::make_unique<IOProcessor>(IOProcessor::audioInputNode), {}, Graph::UpdateKind::none);
+        output = graph.addNode(std::make_unique<IOProcessor>(IOProcessor::audioOutputNode), {}, Graph::UpdateKind::none);
+
+        const Clock::time_point start = Clock::now();
+
+        for (int index = 0; index < testCase.numInstances; ++index) {
+            auto processor = std::make_unique<EqualizerAudioProcessor>();
+
+            const int numPresets = processor->getNumPrograms();
+            const int program = testCase.program >= 0 ? testCase.program : (numPresets > 1 ? 1 + index % (numPresets - 1) : 0);
+            processor->setCurrentProgram(program);
+
+            instances.push_back(processor.get());
+            nodes.push_back(graph.addNode(std::move(processor), {}, Graph::UpdateKind::none));
+        }
+
+        createMs = nanosecondsSince(start) / 1.0e6;
+
+        if (testCase.topology == Topology::Series) {
+            Graph::NodeID previous = input->nodeID;
+            for (const Graph::Node::Ptr& node : nodes) {
+                connect(previous, node->nodeID);
+                previous = node->nodeID;
+            }
+            connect(previous, output->nodeID);
+        } else {
+            for (const Graph::Node::Ptr& node : nodes) {
+                connect(input->nodeID, node->nodeID);
+                connect(node->nodeID, output->nodeID);
+            }
+        }
+    }
+
+    ~GraphSession() {
+        graph.releaseResources();
+    }
+
+    double getCreateMilliseconds() const noexcept { return createMs; }
+
+    BlockResult run(const GraphCase& testCase, int blockSize, CacheEvictor& evictor) {
+        BlockResult result;
+
+        graph.releaseResources();
+        graph.setPlayConfigDetails(2, 2, testCase.sampleRate, blockSize);
+
+        const Clock::time_point start = Clock::now();
+        graph.prepareToPlay(testCase.sampleRate, blockSize);
+        result.prepareMs = nanosecondsSince(start) / 1.0e6;
+
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        juce::MidiBuffer midi;
+        juce::Random random(42);
+
+        const int numBlocks = juce::jmax(8, static_cast<int>(testCase.seconds * testCase.sampleRate / blockSize));
+        const int warmUpBlocks = juce::jmax(8, numBlocks / 10);
+
+        for (int block = 0; block < warmUpBlocks; ++block) {
+            fillWithNoise(buffer, random);
+            graph.processBlock(buffer, midi);
+        }
+
+        std::vector<PerformanceTelemetry::Snapshot> before;
+        for (EqualizerAudioProcessor* instance : instances)
+            before.push_back(instance->getTelemetry().getSnapshot());
+
+        std::vector<double> blockTimes;
+        blockTimes.reserve(static_cast<size_t>(numBlocks));
+
+        for (int block = 0; block < numBlocks; ++block) {
+            fillWithNoise(buffer, random);
+
+            const Clock::time_point blockStart = Clock::now();
+            graph.processBlock(buffer, midi);
+            blockTimes.push_back(nanosecondsSince(blockStart));
+        }
+
+        for (size_t index = 0; index < instances.size(); ++index) {
+            const PerformanceTelemetry::Snapshot spent = instances[index]->getTelemetry().getSnapshot().since(before[index]);
+            result.pluginSeconds += spent.updateSeconds + spent.processSeconds;
+        }
+
+        result.hotSeconds = std::accumulate(blockTimes.begin(), blockTimes.end(), 0.0) / 1.0e9;
+        result.hot = computePercentiles(blockTimes);
+
+        if (evictor.isEnabled()) {
+            std::vector<double> coldTimes;
+            coldTimes.reserve(static_cast<size_t>(numBlocks));
+
+            for (int block = 0; block < numBlocks; ++block) {
+                fillWithNoise(buffer, random);
+                evictor.evict();
+
+                const Clock::time_point blockStart = Clock::now();
+                graph.processBlock(buffer, midi);
+                coldTimes.push_back(nanosecondsSince(blockStart));
+            }
+
+            result.coldMean = computePercentiles(coldTimes).mean;
+        }
+
+        benchmarkSink = buffer.getSample(0, 0);
+        return result;
+    }
+
+private:
+    void connect(Graph::NodeID source, Graph::NodeID destination) {
+        for (int channel = 0; channel < 2; ++channel)
+            graph.addConnection({ { source, channel }, { destination, channel } }, Graph::UpdateKind::none);
+    }
+
+    Graph graph;
+    Graph::Node::Ptr input, output;
+    std::vector<Graph::Node::Ptr> nodes;
+    std::vector<EqualizerAudioProcessor*> instances;    // owned by their nodes
+    double createMs{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GraphSession)
+};
+
+//==============================================================================
+static std::vector<int> parseList(const juce::String& text, std::vector<int> fallback) {
+    if (text.isEmpty())
+        return fallback;
+
+    std::vector<int> values;
+    for (const juce::String& token : juce::StringArray::fromTokens(text, ",", {}))
+        if (token.getIntValue() > 0)
+            values.push_back(token.getIntValue());
+
+    return values.empty() ? fallback : values;
+}
+
+static void runGraphBenchmarks(const std::vector<int>& instanceCounts, const std::vector<int>& blockSizes, double sampleRate,
+                               double seconds, int program, CacheEvictor& evictor, const juce::String& filter) {
+    std::cout << "topology/instances/block        create(ms) prepare(ms)   load%   p50(us)   p99(us)   max(us)  ns/smp/inst  graph%  cold/hot\n";
+
+    for (const Topology topology : { Topology::Series, Topology::Parallel }) {
+        for (const int numInstances : instanceCounts) {
+            const juce::String prefix = juce::String(topology == Topology::Series ? "series" : "parallel") + " x" + juce::String(numInstances);
+
+            std::vector<int> selectedSizes;
+            for (const int blockSize : blockSizes)
+                if (filter.isEmpty() || (prefix + " bs" + juce::String(blockSize)).containsIgnoreCase(filter))
+                    selectedSizes.push_back(blockSize);
+
+            if (selectedSizes.empty())
+                continue;
+
+            const GraphCase testCase{ topology, numInstances, sampleRate, seconds, program };
+            GraphSession session(testCase);
+
+            for (const int blockSize : selectedSizes) {
+                const BlockResult result = session.run(testCase, blockSize, evictor);
+
+                const double blockNanoseconds = 1.0e9 * blockSize / sampleRate;
+                const double samplesPerBlock = 2.0 * blockSize * numInstances;
+                const double graphShare = result.hotSeconds > 0.0 ? 1.0 - result.pluginSeconds / result.hotSeconds : 0.0;
+
+                std::cout << (prefix + " bs" + juce::String(blockSize)).paddedRight(' ', 30)
+                          << juce::String(session.getCreateMilliseconds(), 1).paddedLeft(' ', 11)
+                          << juce::String(result.prepareMs, 1).paddedLeft(' ', 12)
+                          << juce::String(100.0 * result.hot.mean / blockNanoseconds, 2).paddedLeft(' ', 8)
+                          << juce::String(result.hot.p50 / 1000.0, 1).paddedLeft(' ', 10)
+                          << juce::String(result.hot.p99 / 1000.0, 1).paddedLeft(' ', 10)
+                          << juce::String(result.hot.max / 1000.0, 1).paddedLeft(' ', 10)
+                          << juce::String(result.hot.mean / samplesPerBlock, 2).paddedLeft(' ', 13)
+                          << juce::String(100.0 * juce::jmax(0.0, graphShare), 1).paddedLeft(' ', 8)
+                          << (evictor.isEnabled() ? juce::String(result.coldMean / result.hot.mean, 2) : juce::String("-")).paddedLeft(' ', 10)
+                          << "\n" << std::flush;
+            }
+        }
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[]) {
+    const juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h")) {
+        std::cout << "Usage: GraphBenchmark [--quick] [--instances <n,n,...>] [--block-sizes <n,n,...>] [--rate <hz>] [--seconds <s>]\n"
+                     "                      [--program <index>] [--evict-mb <mb>] [--filter <text>] [--kernels <scalar|avx2|avx512>]\n"
+                     "  --program   factory preset for every instance; by default they cycle through the presets\n"
+                     "  --evict-mb  size of the buffer swept before each cold block; 0 skips the cold run\n";
+        return 0;
+    }
+
+    if (args.containsOption("--kernels")) {
+        const int variant = DSPKernels::findVariant(args.getValueForOption("--kernels"));
+
+        if (variant < 0 || DSPKernels::get(static_cast<DSPKernels::Variant>(variant)) == nullptr) {
+            std::cerr << "Kernels " << args.getValueForOption("--kernels") << " aren't in this build or can't run on this CPU\n";
+            return 1;
+        }
+
+        DSPKernels::setForcedVariant(variant);
+    }
+
+    // AudioProcessorValueTreeState needs a message manager for its timer.
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const bool quick = args.containsOption("--quick");
+    const std::vector<int> instanceCounts = parseList(args.getValueForOption("--instances"),
+                                                      quick ? std::vector<int>{ 1, 16, 128 } : std::vector<int>{ 1, 4, 16, 64, 256, 512 });
+    const std::vector<int> blockSizes = parseList(args.getValueForOption("--block-sizes"),
+                                                  quick ? std::vector<int>{ 256 } : std::vector<int>{ 64, 256, 1024 });
+    const double sampleRate = args.containsOption("--rate") ? juce::jlimit(8000.0, 384000.0, args.getValueForOption("--rate").getDoubleValue()) : 48000.0;
+    const double seconds = args.containsOption("--seconds") ? juce::jmax(0.05, args.getValueForOption("--seconds").getDoubleValue()) : (quick ? 0.5 : 2.0);
+    const int program = args.containsOption("--program") ? args.getValueForOption("--program").getIntValue() : -1;
+    const int evictMegabytes = args.containsOption("--evict-mb") ? juce::jlimit(0, 1024, args.getValueForOption("--evict-mb").getIntValue()) : 64;
+
+    CacheEvictor evictor(static_cast<size_t>(evictMegabytes) << 20);
+
+    std::cout << juce::SystemStats::getJUCEVersion() << ", " << juce::SystemStats::getCpuModel() << ", "
+              << juce::String(sampleRate / 1000.0, 1) << " kHz stereo, " << EQEngine::laneWidth << " SIMD lanes, " << DSPKernels::select().name << " kernels\n\n";
+
+    runGraphBenchmarks(instanceCounts, blockSizes, sampleRate, seconds, program, evictor, args.getValueForOption("--filter"));
+    return 0;
+}
@@ -0,0 +1,288 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+
+    Headless batch renderer: applies one EQ setting to many WAV/AIFF files,
+    streaming each file through the engine in fixed-size chunks on a
+    work-stealing pool.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../../Source/ChainSettings.h"
+#include "../../../Source/EQCoefficients.h"
+#include "../../../Source/DynamicEQ.h"
+#include "../../../Source/EQEngine.h"
+#include "../../../Source/PluginState.h"
+#include "../../../Source/WorkStealingPool.h"
+
+//==============================================================================
+struct RenderJob {
+    juce::File input;
+    juce::File output;
+};
+
+struct WorkerStats {
+    std::atomic<juce::int64> frames{ 0 };
+    std::atomic<juce::int64> samples{ 0 };
+    std::atomic<double> busySeconds{ 0.0 };
+};
+
+static void printUsage() {
+    std::cout << "Usage: OfflineRender --output <dir> [options] <input files or folders...>\n"
+                 "\n"
+                 "Options:\n"
+                 "  --state <file>          Plugin state saved by getStateInformation\n"
+                 "  --set <ParamID>=<value> Override one parameter, e.g. --set Peak1Gain=3.5 (repeatable)\n"
+                 "  --jobs <n>              Worker threads (default: number of CPU cores)\n"
+                 "  --chunk <samples>       Streaming chunk size (default: 4096)\n"
+                 "\n"
+                 "Parameters that are neither in the state nor set default to ChainSettings' defaults.\n"
+                 "Linear-phase mode isn't rendered: states with it on are rendered through the IIR engine, with a warning.\n";
+}
+
+static bool renderFile(const RenderJob& job, const ChainSettings& chainSettings, int chunkSize,
+                       juce::AudioFormatManager& formatManager, WorkerStats& stats, juce::String& error) {
+    if (job.output == job.input) {
+        error = "output would overwrite " + job.input.getFullPathName();
+        return false;
+    }
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(job.input));
+    if (reader == nullptr) {
+        error = "cannot read " + job.input.getFullPathName();
+        return false;
+    }
+
+    juce::AudioFormat* format = formatManager.findFormatForFileExtension(job.output.getFileExtension());
+    if (format == nullptr) {
+        error = "no writer for " + job.output.getFileName();
+        return false;
+    }
+
+    job.output.deleteFile();
+    std::unique_ptr<juce::FileOutputStream> stream(job.output.createOutputStream());
+    if (stream == nullptr) {
+        error = "cannot write " + job.output.getFullPathName();
+        return false;
+    }
+
+    const int numChannels = static_cast<int>(reader->numChannels);
+    std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(stream.get(), reader->sampleRate,
+        static_cast<unsigned int>(numChannels), static_cast<int>(reader->bitsPerSample), reader->metadataValues, 0));
+    if (writer == nullptr) {
+        error = "unsupported output format for " + job.output.getFileName();
+        return false;
+    }
+    stream.release();   // now owned by the writer
+
+    // Pool threads start with denormals on; a stem that fades out would
+    // otherwise crawl through its tail and skew the throughput figures.
+    const juce::ScopedNoDenormals noDenormals;
+
+    EQEngine engine;
+    engine.prepare(reader->sampleRate, chunkSize, numChannels);
+    engine.setOversamplingOrder(chainSettings.oversamplingOrder);
+    engine.setCoefficients(designEQCoefficients(chainSettings, getProcessingSampleRate(chainSettings, reader->sampleRate)));
+
+    // Dynamic bands key from the file itself; there is no sidechain offline.
+    DynamicEQ dynamics;
+    dynamics.prepare(reader->sampleRate, chunkSize, numChannels);
+    dynamics.setSettings(chainSettings, getProcessingSampleRate(chainSettings, reader->sampleRate));
+
+    // One chunk-sized buffer per file: memory stays constant however long the file is.
+    juce::AudioBuffer<float> buffer(numChannels, chunkSize);
+    const juce::int64 totalFrames = reader->lengthInSamples;
+    const juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+
+    // The oversampler delays everything by its latency: drop that much from
+    // the start and run as much silence past the end, so the output lines up
+    // with the input and keeps its tail.
+    const int latency = EQEngine::getOversamplingLatency(chainSettings.oversamplingOrder);
+    const juce::int64 paddedFrames = totalFrames + latency;
+    int framesToDrop = latency;
+
+    for (juce::int64 position = 0; position < paddedFrames; position += chunkSize) {
+        const int numFrames = static_cast<int>(juce::jmin<juce::int64>(chunkSize, paddedFrames - position));
+
+        // Past the end of the file the reader fills in silence.
+        reader->read(&buffer, 0, numFrames, position, true, true);
+
+        juce::dsp::AudioBlock<float> block(buffer);
+
+        if (dynamics.isActive())
+            dynamics.process(engine, chainSettings, block.getSubBlock(0, static_cast<size_t>(numFrames)));
+        else
+            engine.process(block.getSubBlock(0, static_cast<size_t>(numFrames)));
+
+        const int dropped = juce::jmin(framesToDrop, numFrames);
+        framesToDrop -= dropped;
+
+        if (dropped < numFrames && !writer->writeFromAudioSampleBuffer(buffer, dropped, numFrames - dropped)) {
+            error = "write failed for " + job.output.getFullPathName();
+            return false;
+        }
+    }
+
+    const double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    stats.frames += totalFrames;
+    stats.samples += totalFrames * numChannels;
+    stats.busySeconds.store(stats.busySeconds.load() + seconds);
+    return true;
+}
+
+static juce::Array<juce::File> collectInputs(const juce::ArgumentList& args) {
+    juce::Array<juce::File> inputs;
+
+    for (int index = 0; index < args.size(); ++index) {
+        const juce::ArgumentList::Argument& argument = args[index];
+
+        if (argument.isOption()) {
+            // Every option takes a value, so skip it as well.
+            ++index;
+            continue;
+        }
+
+        const juce::File file = argument.resolveAsFile();
+        if (file.isDirectory())
+            inputs.addArray(file.findChildFiles(juce::File::findFiles, true, "*.wav;*.wave;*.aif;*.aiff"));
+        else if (file.existsAsFile())
+            inputs.add(file);
+        else
+            std::cerr << "Skipping missing input " << file.getFullPathName() << "\n";
+    }
+
+    return inputs;
+}
+
+static bool parseSettings(const juce::ArgumentList& args, ChainSettings& chainSettings) {
+    if (args.containsOption("--state")) {
+        juce::MemoryBlock data;
+        const juce::File stateFile = args.getFileForOption("--state");
+
+        if (!stateFile.existsAsFile() || !stateFile.loadFileAsData(data)) {
+            std::cerr << "Cannot read state file " << stateFile.getFullPathName() << "\n";
+            return false;
+        }
+
+        // Either the binary format or the ValueTree one older versions saved.
+        PluginState state;
+        if (!readPluginState(data.getData(), static_cast<int>(data.getSize()), state)) {
+            std::cerr << "Not a plugin state file: " << stateFile.getFullPathName() << "\n";
+            return false;
+        }
+
+        chainSettings = getChainSettings(state.parameters);
+    }
+
+    for (int index = 0; index + 1 < args.size(); ++index) {
+        if (args[index].text != "--set")
+            continue;
+
+        const juce::String assignment = args[index + 1].text;
+        const juce::String parameterID = assignment.upToFirstOccurrenceOf("=", false, false).trim();
+        const float value = assignment.fromFirstOccurrenceOf("=", false, false).getFloatValue();
+
+        if (!setChainSettingsParameter(chainSettings, parameterID, value)) {
+            std::cerr << "Unknown parameter " << parameterID << "\n";
+            return false;
+        }
+    }
+
+    // LinearPhaseEngine only gets its kernels from a running coefficient
+    // pipeline, so it isn't available here; say so rather than quietly
+    // rendering something else.
+    if (chainSettings.linearPhase) {
+        std::cerr << "Warning: linear-phase mode can't be rendered offline; rendering with the IIR engine instead\n";
+        chainSettings.linearPhase = false;
+    }
+
+    return true;
+}
+
+//==============================================================================
+int main(int argc, char* argv[]) {
+    const juce::ArgumentList args(argc, argv);
+
+    if (args.size() == 0 || args.containsOption("--help|-h") || !args.containsOption("--output")) {
+        printUsage();
+        return 1;
+    }
+
+    ChainSettings chainSettings;
+    if (!parseSettings(args, chainSettings))
+        return 1;
+
+    const juce::File outputDirectory = args.getFileForOption("--output");
+    if (!outputDirectory.createDirectory()) {
+        std::cerr << "Cannot create output folder " << outputDirectory.getFullPathName() << "\n";
+        return 1;
+    }
+
+    const int numWorkers = args.containsOption("--jobs") ? juce::jmax(1, args.getValueForOption("--jobs").getIntValue())
+                                                         : juce::SystemStats::getNumCpus();
+    const int chunkSize = args.containsOption("--chunk") ? juce::jlimit(64, 1 << 20, args.getValueForOption("--chunk").getIntValue())
+                                                         : 4096;
+
+    const juce::Array<juce::File> inputs = collectInputs(args);
+    if (inputs.isEmpty()) {
+        std::cerr << "No input files\n";
+        return 1;
+    }
+
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    std::vector<WorkerStats> stats(static_cast<size_t>(numWorkers));
+    std::atomic<int> numFailed{ 0 };
+    juce::CriticalSection outputLock;
+
+    const juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+    {
+        WorkStealingPool pool(numWorkers, "Render Worker");
+
+        for (const juce::File& input : inputs) {
+            const RenderJob job{ input, outputDirectory.getChildFile(input.getFileName()) };
+
+            pool.submit([&, job] {
+                WorkerStats& workerStats = stats[static_cast<size_t>(WorkStealingPool::getCurrentWorkerIndex())];
+                juce::String error;
+
+                const bool ok = renderFile(job, chainSettings, chunkSize, formatManager, workerStats, error);
+
+                const juce::ScopedLock sl(outputLock);
+                if (ok) {
+                    std::cout << "Rendered " << job.output.getFullPathName() << "\n";
+                }
+                else {
+                    std::cerr << "Failed: " << error << "\n";
+                    ++numFailed;
+                }
+            });
+        }
+
+        pool.waitForAll();
+    }
+    const double wallSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+
+    juce::int64 totalSamples = 0;
+    std::cout << "\nWorker  files-time(s)  samples/sec\n";
+    for (int worker = 0; worker < numWorkers; ++worker) {
+        const WorkerStats& workerStats = stats[static_cast<size_t>(worker)];
+        const double busy = workerStats.busySeconds.load();
+        totalSamples += workerStats.samples.load();
+
+        std::cout << juce::String(worker + 1).paddedLeft(' ', 6) << "  "
+                  << juce::String(busy, 3).paddedLeft(' ', 13) << "  "
+                  << juce::String(busy > 0.0 ? workerStats.samples.load() / busy : 0.0, 0).paddedLeft(' ', 11) << "\n";
+    }
+
+    std::cout << "\n" << inputs.size() - numFailed.load() << " of " << inputs.size() << " files in "
+              << juce::String(wallSeconds, 3) << " s, "
+              << juce::String(wallSeconds > 0.0 ? totalSamples / wallSeconds : 0.0, 0) << " samples/sec overall, "
+              << juce::String(wallSeconds > 0.0 ? totalSamples / wallSeconds / numWorkers : 0.0, 0) << " samples/sec per core\n";
+
+    return numFailed.load() == 0 ? 0 : 1;
+}
@@ -0,0 +1,186 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+
+    Load test for EQStreamServer: drives many streams of synthetic noise,
+    each with its own randomised settings, through one server and reports
+    how many blocks met their deadline, per-cycle wall times and CPU load.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../../Source/ChainSettings.h"
+#include "../../../Source/EQStreamServer.h"
+
+//==============================================================================
+struct StreamBuffers {
+    EQStreamServer::StreamID id;
+    juce::AudioBuffer<float> audio;
+    juce::Random random;
+};
+
+static void printUsage() {
+    std::cout << "Usage: StreamLoadTest [options]\n"
+                 "\n"
+                 "Options:\n"
+                 "  --streams <n>        Independent streams (default: 64)\n"
+                 "  --block <samples>    Block size per stream (default: 256)\n"
+                 "  --rate <Hz>          Sample rate of every stream (default: 48000)\n"
+                 "  --channels <n>       Channels per stream (default: 2)\n"
+                 "  --seconds <s>        Audio time to process per stream (default: 10)\n"
+                 "  --jobs <n>           Worker threads (default: number of CPU cores)\n"
+                 "  --flat-out           Don't wait for each block period; run cycles back to back\n";
+}
+
+static void fillWithNoise(juce::AudioBuffer<float>& buffer, juce::Random& random) {
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
+        float* samples = buffer.getWritePointer(channel);
+        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+            samples[sample] = random.nextFloat() * 0.5f - 0.25f;
+    }
+}
+
+static float randomBetween(juce::Random& random, float low, float high) {
+    return low + (high - low) * random.nextFloat();
+}
+
+// Cut frequencies and band frequencies spread log-uniformly; about a quarter
+// of the streams have dynamic peak bands and an eighth run oversampled.
+static ChainSettings makeRandomSettings(juce::Random& random) {
+    auto logBetween = [&random](float low, float high) { return low * std::pow(high / low, random.nextFloat()); };
+
+    ChainSettings settings;
+    settings.lowCutFrequency = logBetween(20.0f, 300.0f);
+    settings.highCutFrequency = logBetween(5000.0f, 20000.0f);
+    settings.lowCutSlope = static_cast<Slope>(random.nextInt(4));
+    settings.highCutSlope = static_cast<Slope>(random.nextInt(4));
+    settings.peak1Frequency = logBetween(60.0f, 2000.0f);
+    settings.peak1GainInDecibels = randomBetween(random, -12.0f, 12.0f);
+    settings.peak1Quality = logBetween(0.3f, 6.0f);
+    settings.peak2Frequency = logBetween(1000.0f, 16000.0f);
+    settings.peak2GainInDecibels = randomBetween(random, -12.0f, 12.0f);
+    settings.peak2Quality = logBetween(0.3f, 6.0f);
+
+    if (random.nextInt(4) == 0) {
+        settings.peak1Dynamics.enabled = true;
+        settings.peak1Dynamics.thresholdInDecibels = -30.0f;
+    }
+
+    if (random.nextInt(8) == 0)
+        settings.oversamplingOrder = 1;
+
+    for (int band = random.nextInt(5); --band >= 0;) {
+        BandSettings& extra = settings.extraBands[static_cast<size_t>(band)];
+        extra.enabled = true;
+        extra.frequency = logBetween(40.0f, 16000.0f);
+        extra.gainInDecibels = randomBetween(random, -9.0f, 9.0f);
+        extra.quality = logBetween(0.5f, 4.0f);
+    }
+
+    return settings;
+}
+
+static double percentile(const std::vector<double>& sorted, double fraction) {
+    return sorted.empty() ? 0.0 : sorted[juce::jmin(sorted.size() - 1, static_cast<size_t>(fraction * static_cast<double>(sorted.size())))];
+}
+
+//==============================================================================
+int main(int argc, char* argv[]) {
+    const juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h")) {
+        printUsage();
+        return 0;
+    }
+
+    auto intOption = [&args](const juce::String& option, int fallback, int low, int high) {
+        return args.containsOption(option) ? juce::jlimit(low, high, args.getValueForOption(option).getIntValue()) : fallback;
+    };
+
+    const int numStreams = intOption("--streams", 64, 1, 4096);
+    const int blockSize = intOption("--block", 256, 16, 8192);
+    const int numChannels = intOption("--channels", 2, 1, 64);
+    const int numWorkers = intOption("--jobs", juce::SystemStats::getNumCpus(), 1, 256);
+    const double sampleRate = args.containsOption("--rate") ? juce::jlimit(8000.0, 384000.0, args.getValueForOption("--rate").getDoubleValue()) : 48000.0;
+    const double seconds = args.containsOption("--seconds") ? juce::jmax(0.1, args.getValueForOption("--seconds").getDoubleValue()) : 10.0;
+    const bool paced = !args.containsOption("--flat-out");
+
+    const double blockMs = 1000.0 * blockSize / sampleRate;
+    const int numCycles = juce::jmax(1, static_cast<int>(seconds * sampleRate / blockSize));
+
+    EQStreamServer server(numWorkers);
+    juce::Random random(42);
+
+    std::vector<std::unique_ptr<StreamBuffers>> streams;
+    for (int index = 0; index < numStreams; ++index) {
+        auto stream = std::make_unique<StreamBuffers>();
+        stream->id = server.addStream(sampleRate, numChannels, blockSize, makeRandomSettings(random));
+        stream->audio.setSize(numChannels, blockSize);
+        stream->random.setSeed(1000 + index);
+        streams.push_back(std::move(stream));
+    }
+
+    std::cout << numStreams << " streams x " << numChannels << " channels, " << blockSize << " samples at "
+              << sampleRate << " Hz (" << juce::String(blockMs, 3) << " ms period), "
+              << server.getNumWorkers() << " workers, " << (paced ? "paced" : "flat out") << "\n";
+
+    std::vector<double> cycleTimes;
+    cycleTimes.reserve(static_cast<size_t>(numCycles));
+
+    const double startMs = juce::Time::getMillisecondCounterHiRes();
+
+    for (int cycle = 0; cycle < numCycles; ++cycle) {
+        const double periodStartMs = paced ? startMs + cycle * blockMs : juce::Time::getMillisecondCounterHiRes();
+
+        if (paced)
+            while (juce::Time::getMillisecondCounterHiRes() < periodStartMs)
+                juce::Thread::yield();
+
+        // Now and then a stream's settings change, as automation would.
+        if (cycle % 16 == 0) {
+            const StreamBuffers& changed = *streams[static_cast<size_t>(random.nextInt(numStreams))];
+            server.setSettings(changed.id, makeRandomSettings(random));
+        }
+
+        for (auto& stream : streams) {
+            fillWithNoise(stream->audio, stream->random);
+            server.submit(stream->id, stream->audio.getArrayOfWritePointers(), blockSize, periodStartMs + blockMs);
+        }
+
+        const double cycleStartMs = juce::Time::getMillisecondCounterHiRes();
+        server.processPending();
+        cycleTimes.push_back(juce::Time::getMillisecondCounterHiRes() - cycleStartMs);
+    }
+
+    const double wallSeconds = (juce::Time::getMillisecondCounterHiRes() - startMs) / 1000.0;
+
+    juce::int64 totalBlocks = 0, totalMisses = 0;
+    double totalCpuSeconds = 0.0, maxLatencyMs = 0.0, meanLatencyMs = 0.0, maxLoad = 0.0;
+
+    for (const auto& stream : streams) {
+        const EQStreamServer::StreamStats stats = server.getStats(stream->id);
+        totalBlocks += stats.blocks;
+        totalMisses += stats.deadlineMisses;
+        totalCpuSeconds += stats.cpuSeconds;
+        meanLatencyMs += stats.meanLatencyMs / numStreams;
+        maxLatencyMs = juce::jmax(maxLatencyMs, stats.maxLatencyMs);
+        maxLoad = juce::jmax(maxLoad, stats.realtimeLoad);
+    }
+
+    std::sort(cycleTimes.begin(), cycleTimes.end());
+
+    std::cout << "\nCycle time (ms)   p50 " << juce::String(percentile(cycleTimes, 0.5), 3)
+              << "   p90 " << juce::String(percentile(cycleTimes, 0.9), 3)
+              << "   p99 " << juce::String(percentile(cycleTimes, 0.99), 3)
+              << "   max " << juce::String(cycleTimes.back(), 3) << "\n"
+              << "Block latency (ms) mean " << juce::String(meanLatencyMs, 3) << "   max " << juce::String(maxLatencyMs, 3) << "\n"
+              << "Deadline misses   " << totalMisses << " of " << totalBlocks << " blocks ("
+              << juce::String(totalBlocks > 0 ? 100.0 * static_cast<double>(totalMisses) / static_cast<double>(totalBlocks) : 0.0, 2) << "%)\n"
+              << "CPU               " << juce::String(totalCpuSeconds, 3) << " s in " << juce::String(wallSeconds, 3) << " s wall, "
+              << juce::String(wallSeconds > 0.0 ? 100.0 * totalCpuSeconds / (wallSeconds * server.getNumWorkers()) : 0.0, 1) << "% of the workers, "
+              << "heaviest stream at " << juce::String(100.0 * maxLoad, 2) << "% of realtime\n";
+
+    return totalMisses == 0 ? 0 : 1;
+}